@@ -321,7 +321,22 @@ function SearchBox(name, resultsPath, inFrame, label)
     var hasResultsPage;
 
     var idx = indexSectionsWithContent[this.searchIndex].indexOf(idxChar);
-    if (idx!=-1)
+    if (typeof searchShards!='undefined') // compact index, shards are loaded by the results page
+    {
+       if (searchShardKeys(searchValue).length>0)
+       {
+         resultsPage = this.resultsPath + '/results.html';
+         resultsPageWithSearch = resultsPage+'?'+this.searchIndex+'&'+escape(searchValue);
+         hasResultsPage = true;
+       }
+       else
+       {
+         resultsPage = this.resultsPath + '/nomatches.html';
+         resultsPageWithSearch = resultsPage;
+         hasResultsPage = false;
+       }
+    }
+    else if (idx!=-1)
     {
        var hexCode=idx.toString(10);
        resultsPage = this.resultsPath + '/' + indexSectionNames[this.searchIndex] + '_' + hexCode + '.html';
@@ -789,3 +804,128 @@ function init_search()
   searchBox.OnSelectItem(0);
 }
 
+// -----------------------------------------------------------------------
+// compact search index, see writeCompactSearchIndex() in searchindex.cpp
+
+var searchShardData = [];
+var searchShardsPending = 0;
+var searchShardSection = 0;
+var searchShardQuery = '';
+
+// see also function searchShardFile() in searchindex.cpp, which should match in behaviour
+function searchShardFile(key)
+{
+  var result = 'shard';
+  for (var i=0;i<key.length;i++)
+  {
+    result+='_'+('000'+key.charCodeAt(i).toString(16)).slice(-4);
+  }
+  return result;
+}
+
+// returns the shards which may contain names starting with search
+function searchShardKeys(search)
+{
+  var key = search.replace(/^ +/, "").toLowerCase().substr(0, 2);
+  var result = [];
+  if (key.length==0)
+  {
+    return result;
+  }
+  for (var i=0;i<searchShards.length;i++)
+  {
+    if (searchShards[i].substr(0, key.length)==key)
+    {
+      result.push(searchShards[i]);
+    }
+  }
+  return result;
+}
+
+// called by the results page, the query is passed as ?<section>&<search>
+function loadSearchShards()
+{
+  var query = unescape(window.location.search.substring(1));
+  var sep = query.indexOf('&');
+  searchShardSection = parseInt(query.substring(0, sep));
+  searchShardQuery = query.substring(sep+1);
+
+  var keys = searchShardKeys(searchShardQuery);
+  searchShardsPending = keys.length;
+  if (keys.length==0)
+  {
+    showSearchShards();
+    return;
+  }
+
+  var head = document.getElementsByTagName('head')[0];
+  for (var i=0;i<keys.length;i++)
+  {
+    var script = document.createElement('script');
+    script.type = 'text/javascript';
+    script.src = searchShardFile(keys[i])+'.js';
+    script.onerror = searchShardDone;
+    head.appendChild(script);
+  }
+}
+
+// called by each shard file
+function searchShard(file, strings, items)
+{
+  searchShardData.push([file, strings, items]);
+  searchShardDone();
+}
+
+function searchShardDone()
+{
+  searchShardsPending--;
+  if (searchShardsPending==0)
+  {
+    showSearchShards();
+  }
+}
+
+// converts the items of the selected section to the searchData format used by createResults()
+function showSearchShards()
+{
+  var mask = indexSectionMasks[searchShardSection];
+  searchShardData.sort(function(a, b) { return a[0]<b[0] ? -1 : (a[0]>b[0] ? 1 : 0); });
+
+  searchData = [];
+  for (var s=0;s<searchShardData.length;s++)
+  {
+    var strings = searchShardData[s][1];
+    var items = searchShardData[s][2];
+    for (var e=0;e<items.length;e++)
+    {
+      var children = [];
+      for (var c=0;c<items[e][2].length;c++)
+      {
+        if (items[e][2][c][2] & mask)
+        {
+          children.push(items[e][2][c]);
+        }
+      }
+      if (children.length==0)
+      {
+        continue;
+      }
+      var entry = [items[e][1]];
+      for (var c=0;c<children.length;c++)
+      {
+        var child = children[c];
+        var url = strings[child[0]];
+        if (child[1]!='')
+        {
+          url+='#'+child[1];
+        }
+        entry.push([url, child[2] & 1, strings[children.length==1 ? child[3] : child[4]]]);
+      }
+      searchData.push([items[e][0], entry]);
+    }
+  }
+
+  createResults();
+  document.getElementById("Loading").style.display="none";
+  searchResults.Search(searchShardQuery);
+}
@@ -16,6 +16,7 @@
 *
 *************************************************************************/
 
+#include <QCryptographicHash>
 #include <QDir>
 
 #include <config.h>
@@ -108,6 +109,46 @@ QString Config::getString(const QString &name)
    return retval;
 }
 
+QByteArray Config::getSettingsHash(const QStringList &ignore)
+{
+   QStringList settings;
+
+   for (auto iter = m_cfgBool.begin(); iter != m_cfgBool.end(); ++iter) {
+      if (! ignore.contains(iter.key())) {
+         settings.append(iter.key() + "=" + (iter.value().value ? "true" : "false"));
+      }
+   }
+
+   for (auto iter = m_cfgInt.begin(); iter != m_cfgInt.end(); ++iter) {
+      if (! ignore.contains(iter.key())) {
+         settings.append(iter.key() + "=" + QString::number(iter.value().value));
+      }
+   }
+
+   for (auto iter = m_cfgEnum.begin(); iter != m_cfgEnum.end(); ++iter) {
+      if (! ignore.contains(iter.key())) {
+         settings.append(iter.key() + "=" + iter.value().value);
+      }
+   }
+
+   for (auto iter = m_cfgList.begin(); iter != m_cfgList.end(); ++iter) {
+      if (! ignore.contains(iter.key())) {
+         settings.append(iter.key() + "=" + iter.value().value.join("\n"));
+      }
+   }
+
+   for (auto iter = m_cfgString.begin(); iter != m_cfgString.end(); ++iter) {
+      if (! ignore.contains(iter.key())) {
+         settings.append(iter.key() + "=" + iter.value().value);
+      }
+   }
+
+   // hash order is not stable between runs
+   settings.sort();
+
+   return QCryptographicHash::hash(settings.join("\n").toUtf8(), QCryptographicHash::Md5);
+}
+
 // update project data
 void Config::setBool(const QString &name, bool data)
 {
@@ -657,6 +698,17 @@ bool Config::verify()
       iterInt.value().value = 1000;
    }
 
+   iterInt = m_cfgInt.find("dot-batch-size");
+   int batchSize = iterInt.value().value;
+
+   if (batchSize < 1) {
+      iterInt.value().value = 1;
+
+   } else if (batchSize > 256) {
+      // command line length
+      iterInt.value().value = 256;
+   }
+
 
    // ** html
    iterString = m_cfgString.find("html-file-extension");
@@ -715,6 +767,18 @@ bool Config::verify()
    iterInt.value().value = gamma;
 
 
+   // **
+   iterInt = m_cfgInt.find("png-compression-level");
+   int pngLevel = iterInt.value().value;
+
+   if (pngLevel < 0) {
+      iterInt.value().value = 0;
+
+   } else if (pngLevel > 9) {
+      iterInt.value().value = 9;
+   }
+
+
    // **
    iterEnum = m_cfgEnum.find("mathjax-format");
    QString mathJaxFormat = iterEnum.value().value;
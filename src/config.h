@@ -45,6 +45,9 @@ class Config
 
       static Qt::CaseSensitivity getCase(const QString &name);
 
+      // hash of all project settings, except for the ones listed in ignore
+      static QByteArray getSettingsHash(const QStringList &ignore);
+
       enum DataSource { DEFAULT, PROJECT };
 
       struct struc_CfgBool {
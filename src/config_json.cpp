@@ -142,6 +142,12 @@ void Config::load_Defaults()
 
    m_cfgInt.insert("tab-size",                   struc_CfgInt    { 4,              DEFAULT } );
    m_cfgInt.insert("lookup-cache-size",          struc_CfgInt    { 0,              DEFAULT } );
+   m_cfgInt.insert("parse-num-threads",          struc_CfgInt    { 1,              DEFAULT } );
+   m_cfgInt.insert("doc-cache-size",             struc_CfgInt    { 64,             DEFAULT } );
+   m_cfgInt.insert("file-cache-size",            struc_CfgInt    { 32,             DEFAULT } );
+   m_cfgString.insert("file-cache-dir",          struc_CfgString { QString(),      DEFAULT } );
+   m_cfgInt.insert("file-cache-dir-size",        struc_CfgInt    { 256,            DEFAULT } );
+   m_cfgString.insert("entry-cache-dir",         struc_CfgString { QString(),      DEFAULT } );
 
    // tab 2 - build configuration
    m_cfgBool.insert("extract-all",               struc_CfgBool   { false,          DEFAULT } );
@@ -229,6 +235,8 @@ void Config::load_Defaults()
    m_cfgBool.insert("warn-undoc-param",          struc_CfgBool   { false,           DEFAULT } );
    m_cfgString.insert("warn-format",             struc_CfgString { "$file:$line: $text", DEFAULT } );
    m_cfgString.insert("warn-logfile",            struc_CfgString { QString(),       DEFAULT } );
+   m_cfgBool.insert("statistics-summary",        struc_CfgBool   { false,           DEFAULT } );
+   m_cfgString.insert("statistics-file",         struc_CfgString { QString(),       DEFAULT } );
 
    // tab 2 -input source files
    m_cfgList.insert("input-source",              struc_CfgList   { QStringList(),   DEFAULT } );
@@ -287,6 +295,7 @@ void Config::load_Defaults()
    m_cfgString.insert("clang-dialect",           struc_CfgString { "--std=c++14",   DEFAULT } );
    m_cfgBool.insert("clang-use-headers",         struc_CfgBool   { true,            DEFAULT } );
    m_cfgList.insert("clang-flags",               struc_CfgList   { QStringList(),   DEFAULT } );
+   m_cfgString.insert("clang-cache-dir",         struc_CfgString { QString(),       DEFAULT } );
 
    // tab 2 - source listing
    m_cfgBool.insert("source-code",               struc_CfgBool   { false,           DEFAULT } );
@@ -323,6 +332,9 @@ void Config::load_Defaults()
    m_cfgBool.insert("hide-undoc-relations",      struc_CfgBool   { true,            DEFAULT } );
    m_cfgBool.insert("have-dot",                  struc_CfgBool   { false,           DEFAULT } );
    m_cfgInt.insert("dot-num-threads",            struc_CfgInt    { 0,               DEFAULT } );
+   m_cfgInt.insert("dot-batch-size",             struc_CfgInt    { 1,               DEFAULT } );
+   m_cfgString.insert("dot-cache-dir",           struc_CfgString { QString(),       DEFAULT } );
+   m_cfgInt.insert("dot-cache-size",             struc_CfgInt    { 256,             DEFAULT } );
    m_cfgString.insert("dot-font-name",           struc_CfgString { "Helvetica",     DEFAULT } );
    m_cfgInt.insert("dot-font-size",              struc_CfgInt    { 10,              DEFAULT } );
    m_cfgString.insert("dot-font-path",           struc_CfgString { QString(),       DEFAULT } );
@@ -357,6 +369,7 @@ void Config::load_Defaults()
    m_cfgBool.insert("generate-man",              struc_CfgBool   { false,           DEFAULT } );
    m_cfgBool.insert("generate-xml",              struc_CfgBool   { false,           DEFAULT } );
    m_cfgBool.insert("generate-docbook",          struc_CfgBool   { false,           DEFAULT } );
+   m_cfgBool.insert("output-async-write",        struc_CfgBool   { false,           DEFAULT } );
 
    m_cfgBool.insert("dot-class-graph",           struc_CfgBool   { true,            DEFAULT } );
    m_cfgBool.insert("dot-collaboration",         struc_CfgBool   { true,            DEFAULT } );
@@ -390,6 +403,7 @@ void Config::load_Defaults()
 
    m_cfgBool.insert("html-search",               struc_CfgBool   { true,             DEFAULT } );
    m_cfgBool.insert("search-server-based",       struc_CfgBool   { false,            DEFAULT } );
+   m_cfgBool.insert("search-compact-index",      struc_CfgBool   { false,            DEFAULT } );
    m_cfgBool.insert("search-external",           struc_CfgBool   { false,            DEFAULT } );
    m_cfgString.insert("search-external-url",     struc_CfgString { QString(),        DEFAULT } );
    m_cfgString.insert("search-data-file",        struc_CfgString { "searchdata.xml", DEFAULT } );
@@ -398,6 +412,7 @@ void Config::load_Defaults()
 
    m_cfgInt.insert("formula-fontsize",           struc_CfgInt    { 10,              DEFAULT } );
    m_cfgBool.insert("formula-transparent",       struc_CfgBool   { true,            DEFAULT } );
+   m_cfgInt.insert("png-compression-level",      struc_CfgInt    { 6,               DEFAULT } );
    m_cfgString.insert("ghostscript",             struc_CfgString { QString(),       DEFAULT } );
    m_cfgBool.insert("use-mathjax",               struc_CfgBool   { false,           DEFAULT } );
    m_cfgEnum.insert("mathjax-format",            struc_CfgEnum   { "HTML-CSS",      DEFAULT } );
@@ -17,6 +17,7 @@
 *************************************************************************/
 
 #include <QRegularExpression>
+#include <QScopedPointer>
 #include <QCryptographicHash>
 
 #include <ctype.h>
@@ -197,7 +198,7 @@ void Definition::addToMap(const QString &name)
 
    if (! phrase.isEmpty()) {
       // must use a raw pointer since this method is called from a constructor
-      Doxy_Globals::glossary().insertMulti(phrase, this);
+      Doxy_Globals::glossary().insert(phrase, this);
       this->setPhraseName(phrase);
    }
 }
@@ -276,18 +277,7 @@ Definition::~Definition()
    }
 
    if (! Doxy_Globals::programExit)  {
-      auto iter = Doxy_Globals::glossary().find(m_phraseName);
-
-      while (iter != Doxy_Globals::glossary().end() && iter.key() == m_phraseName)  {
-
-         if (iter.value() == this) {
-            iter = Doxy_Globals::glossary().erase(iter);
-
-         }  else {
-            ++iter;
-
-         }
-      }
+      Doxy_Globals::glossary().remove(m_phraseName, this);
    }
 }
 
@@ -566,6 +556,107 @@ void Definition::setInbodyDocumentation(const QString &d, const QString &inbodyF
 }
 
 
+/*! Contents of a source file, after running the filter, with the offset of each line */
+struct SourceLineIndex {
+   QByteArray   contents;
+   QVector<int> lineOffsets;      // offset of the first character of line n is at index n - 1
+};
+
+/*! Reads a SourceLineIndex in the same way as a FILE stream, starting at a given line */
+class SourceLineReader
+{
+ public:
+   SourceLineReader(const SourceLineIndex &file)
+      : m_data(file.contents), m_offsets(file.lineOffsets), m_pos(0), m_eof(false)
+   { }
+
+   // move to the start of line lineNr, returns false if the file has less lines
+   bool seekLine(int lineNr) {
+      if (lineNr < 1 || lineNr > m_offsets.size()) {
+         m_pos = m_data.size();
+         m_eof = true;
+
+         return false;
+      }
+
+      m_pos = m_offsets[lineNr - 1];
+
+      return true;
+   }
+
+   int getChar() {
+      if (m_pos >= m_data.size()) {
+         m_eof = true;
+         return EOF;
+      }
+
+      return static_cast<unsigned char>(m_data[m_pos++]);
+   }
+
+   // append the rest of the current line, including the line feed
+   void appendLine(QByteArray &result) {
+      int index = m_data.indexOf('\n', m_pos);
+
+      if (index == -1) {
+         result += m_data.mid(m_pos);
+         m_pos = m_data.size();
+         m_eof = true;
+
+      } else {
+         result += m_data.mid(m_pos, index + 1 - m_pos);
+         m_pos = index + 1;
+      }
+   }
+
+   bool atEnd() const {
+      return m_eof;
+   }
+
+ private:
+   const QByteArray   &m_data;
+   const QVector<int> &m_offsets;
+
+   int  m_pos;
+   bool m_eof;
+};
+
+// line index of the most recently used file, the contents are cached by readInputFile()
+static QScopedPointer<SourceLineIndex> s_sourceLineIndex;
+static QString s_sourceLineIndexName;
+
+/*! Returns the contents of \a fileName, passed through the source filter if \a filter is true. The file
+ *  is read by readInputFile() which caches the contents. The returned pointer is valid until the next call.
+ */
+static SourceLineIndex *getSourceLineIndex(const QString &fileName, bool filter)
+{
+   if (s_sourceLineIndex && s_sourceLineIndexName == fileName) {
+      return s_sourceLineIndex.data();
+   }
+
+   QString text;
+
+   if (! readInputFile(fileName, text, filter, true)) {
+      return nullptr;
+   }
+
+   SourceLineIndex *retval = new SourceLineIndex;
+   retval->contents = text.toUtf8();
+   retval->lineOffsets.append(0);
+
+   const QByteArray &contents = retval->contents;
+
+   for (int i = 0; i < contents.size(); ++i) {
+      if (contents[i] == '\n') {
+         retval->lineOffsets.append(i + 1);
+      }
+   }
+
+   s_sourceLineIndex.reset(retval);
+   s_sourceLineIndexName = fileName;
+
+   return retval;
+}
+
 /*! Reads a fragment of code from file \a fileName starting at
  * line \a startLine and ending at line \a endLine (inclusive). The fragment is
  * stored in \a result. If false is returned the code fragment could not be found
@@ -584,51 +675,35 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
       return false;   // not a valid file name
    }
 
-   QString tmpResult;
+   QByteArray tmpResult;
    QString filter = getFileFilter(fileName, true);
 
-   FILE *f = 0;
    bool usePipe = ! filter.isEmpty() && filterSourceFiles;
 
    SrcLangExt lang = getLanguageFromFileName(fileName);
 
-   if (! usePipe) {
-      // no filter given or wanted
-      f = fopen(fileName.toUtf8().constData(), "r");
-
-   } else {
-      // use filter
-      QString cmd = filter + " \"" + fileName + "\"";
-      f = popen(cmd.toUtf8().constData(), "r");
-   }
+   // contents are cached, the file is only read or filtered once
+   SourceLineIndex *file = getSourceLineIndex(fileName, usePipe);
 
    // for TCL, Python, and Fortran no bracket search is possible
    bool found = (lang == SrcLangExt_Tcl) || (lang == SrcLangExt_Python) || (lang == SrcLangExt_Fortran);
 
-   if (f) {
+   if (file != nullptr) {
+      SourceLineReader f(*file);
+
       int c      = 0;
       int col    = 0;
-      int lineNr = 1;
+      int lineNr = startLine;
 
       // skip until the startLine has reached
-
-      while (lineNr < startLine && !feof(f)) {
-         while ((c = fgetc(f)) != '\n' && c != EOF) /* skip */;
-         lineNr++;
-
-         if (found && c == '\n') {
-            c = '\0';
-         }
-      }
-
-      if (! feof(f)) {
+      if (f.seekLine(startLine)) {
          // skip until the opening bracket or lonely : is found
          char cn = 0;
 
-         while (lineNr <= endLine && ! feof(f) && ! found) {
+         while (lineNr <= endLine && ! f.atEnd() && ! found) {
             int pc = 0;
 
-            while ((c = fgetc(f)) != '{' && c != ':' && c != EOF) {
+            while ((c = f.getChar()) != '{' && c != ':' && c != EOF) {
 
                if (c == '\n') {
                   lineNr++;
@@ -640,7 +715,7 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
                } else if (pc == '/' && c == '/') {
                   // skip single line comment
 
-                  while ((c = fgetc(f)) != '\n' && c != EOF) {
+                  while ((c = f.getChar()) != '\n' && c != EOF) {
                      pc = c;
                   }
 
@@ -651,7 +726,7 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
                } else if (pc == '/' && c == '*') {
                   // skip C style comment
 
-                  while (((c = fgetc(f)) != '/' || pc != '*') && c != EOF) {
+                  while (((c = f.getChar()) != '/' || pc != '*') && c != EOF) {
                      if (c == '\n') {
                         lineNr++;
                         col = 0;
@@ -667,7 +742,7 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
             }
 
             if (c == ':') {
-               cn = fgetc(f);
+               cn = f.getChar();
                if (cn != ':') {
                   found = true;
                }
@@ -683,15 +758,12 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
             // at the right column so that the opening brace lines up with the closing brace
 
             if (endLine != startLine) {
-               QString spaces;
-               spaces.fill(' ', col);
-
-               tmpResult += spaces;
+               tmpResult += QByteArray(col, ' ');
             }
 
             // copy until end of line
             if (c) {
-               tmpResult += c;
+               tmpResult += char(c);
             }
 
             startLine = lineNr;
@@ -704,30 +776,11 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
                }
             }
 
-            const int maxLineLength = 4096;
-            char lineStr[maxLineLength];
-
             do {
-               int size_read;
-
-               do {
-                  // read up to maxLineLength-1 bytes, the last byte being zero
-                  char *p = fgets(lineStr, maxLineLength, f);
-
-                  if (p) {
-                     size_read = qstrlen(p);
-
-                  } else { // nothing read
-                     size_read = -1;
-                     lineStr[0] = '\0';
-                  }
-                  tmpResult += lineStr;
-
-               } while (size_read == (maxLineLength - 1));
-
+               f.appendLine(tmpResult);
                lineNr++;
 
-            } while (lineNr <= endLine && ! feof(f));
+            } while (lineNr <= endLine && ! f.atEnd());
 
             // strip stuff after closing bracket
             int newLineIndex = tmpResult.lastIndexOf('\n');
@@ -742,16 +795,12 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
       }
 
       if (usePipe) {
-         pclose(f);
          Debug::print(Debug::FilterOutput, 0, "Filter output\n");
-         Debug::print(Debug::FilterOutput, 0, "-------------\n%s\n-------------\n", csPrintable(tmpResult));
-
-      } else {
-         fclose(f);
+         Debug::print(Debug::FilterOutput, 0, "-------------\n%s\n-------------\n", tmpResult.constData());
       }
    }
 
-   result = tmpResult;
+   result = QString::fromUtf8(tmpResult);
 
    if (! result.isEmpty() && ! result.endsWith('\n')) {
       result += "\n";
@@ -1516,26 +1516,16 @@ void ClassDiagram::writeImage(QTextStream &t, const QString &path, const QString
    uint imageWidth = (maxXPos + gridWidth) * cellWidth / gridWidth + (maxXPos * labelHorSpacing) / gridWidth;
    uint imageHeight = rows * cellHeight + (rows - 1) * labelVertSpacing;
 
-   Image image(imageWidth, imageHeight);
+   QSharedPointer<Image> image = QMakeShared<Image>(imageWidth, imageHeight);
 
-   base->drawBoxes(t, &image, true, true, baseRows, superRows, cellWidth, cellHeight, relPath, generateMap);
-   super->drawBoxes(t, &image, false, true, baseRows, superRows, cellWidth, cellHeight, relPath, generateMap);
-   base->drawConnectors(t, &image, true, true, baseRows, superRows, cellWidth, cellHeight);
-   super->drawConnectors(t, &image, false, true, baseRows, superRows, cellWidth, cellHeight);
+   base->drawBoxes(t, image.data(), true, true, baseRows, superRows, cellWidth, cellHeight, relPath, generateMap);
+   super->drawBoxes(t, image.data(), false, true, baseRows, superRows, cellWidth, cellHeight, relPath, generateMap);
+   base->drawConnectors(t, image.data(), true, true, baseRows, superRows, cellWidth, cellHeight);
+   super->drawConnectors(t, image.data(), false, true, baseRows, superRows, cellWidth, cellHeight);
 
+   // encoded on a worker thread, skipped if the image did not change
    QString fileName = path + "/" + fName + IMAGE_EXT;
-   QFile f(fileName);
-
-   if (f.open(QIODevice::WriteOnly)) {
-      QByteArray buffer = image.convert();
-
-      f.write(buffer);
-      f.close();
-
-   } else {
-      err("Unable to open file for writing %s, error: %d\n", csPrintable(fileName), f.error());
-
-   }
+   ImageWriter::instance()->write(fileName, image);
 
    Doxy_Globals::indexList.addImageFile(fName + IMAGE_EXT);
 
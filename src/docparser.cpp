@@ -16,6 +16,7 @@
 *
 *************************************************************************/
 
+#include <QCache>
 #include <QFile>
 #include <QFileInfo>
 #include <QStack>
@@ -8133,6 +8134,81 @@ DocRoot *validatingParseDoc(const QString &fileName, int startLine, QSharedPoint
    return root;
 }
 
+// entry in the cache used by cachedParseDoc, the definitions are kept alive so the addresses
+// used in the key are not reused for a different definition
+struct DocCacheItem {
+   QSharedPointer<DocRoot>    root;
+   QSharedPointer<Definition> ctx;
+   QSharedPointer<MemberDef>  md;
+};
+
+static QCache<QString, DocCacheItem> s_docCache;
+
+static int s_docCacheHits   = 0;
+static int s_docCacheMisses = 0;
+
+QSharedPointer<DocRoot> cachedParseDoc(const QString &fileName, int startLine, QSharedPointer<Definition> ctx,
+                  QSharedPointer<MemberDef> md, const QString &input, bool indexWords, bool isExample,
+                  const QString &exampleName, bool singleLine, bool linkFromIndex)
+{
+   // size in MB
+   static const int cacheSize = qMin(Config::getInt("doc-cache-size"), 2047);
+
+   if (cacheSize <= 0) {
+      return QSharedPointer<DocRoot>(validatingParseDoc(fileName, startLine, ctx, md, input, indexWords,
+                  isExample, exampleName, singleLine, linkFromIndex));
+   }
+
+   if (s_docCache.maxCost() != cacheSize * 1024 * 1024) {
+      s_docCache.setMaxCost(cacheSize * 1024 * 1024);
+   }
+
+   // section levels depend on the nesting of the page being written, the tokenizer depends
+   // on markdown support which is switched on or off for some pages
+   QString key = fileName + ':' + QString::number(startLine) + ':' +
+                  QString::number(qulonglong(ctx.data()), 16) + ':' + QString::number(qulonglong(md.data()), 16) + ':' +
+                  QString::number(isExample) + ':' + exampleName + ':' + QString::number(singleLine) + ':' +
+                  QString::number(linkFromIndex) + ':' + QString::number(Doxy_Globals::subpageNestingLevel) + ':' +
+                  QString::number(Doxy_Globals::markdownSupport);
+
+   key += "\n" + input;
+
+   // words are added to the search index while parsing, a cached tree is never used for indexing
+   bool indexing = indexWords && Doxy_Globals::searchIndexBase != nullptr;
+
+   if (! indexing) {
+      DocCacheItem *item = s_docCache.object(key);
+
+      if (item != nullptr) {
+         ++s_docCacheHits;
+         return item->root;
+      }
+   }
+
+   ++s_docCacheMisses;
+
+   DocCacheItem *item = new DocCacheItem;
+   item->root = QSharedPointer<DocRoot>(validatingParseDoc(fileName, startLine, ctx, md, input, indexWords,
+                  isExample, exampleName, singleLine, linkFromIndex));
+   item->ctx  = ctx;
+   item->md   = md;
+
+   QSharedPointer<DocRoot> retval = item->root;
+
+   // the tree is about ten times the size of the text it was parsed from
+   s_docCache.insert(key, item, 10 * key.size_storage());
+
+   return retval;
+}
+
+void printDocCacheStatistics()
+{
+   if (s_docCacheHits + s_docCacheMisses > 0) {
+      msg("Documentation cache used %d/%d KB, %d hits, %d misses\n", s_docCache.totalCost() / 1024,
+                  s_docCache.maxCost() / 1024, s_docCacheHits, s_docCacheMisses);
+   }
+}
+
 DocText *validatingParseText(const QString &input)
 {
    // store parser state so we can re-enter this function if needed
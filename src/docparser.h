@@ -55,6 +55,17 @@ DocRoot *validatingParseDoc(const QString &fileName, int startLine, QSharedPoint
                   QSharedPointer<MemberDef> md, const QString &input, bool indexWords, bool isExample,
                   const QString &exampleName = QString(), bool singleLine = false, bool linkFromIndex = false);
 
+/*! Returns the same tree as validatingParseDoc. Trees are kept in a cache of limited size, parsing the
+ *  same block again in the same context returns the cached tree. The tree is shared with other callers and
+ *  must not be modified or deleted.
+ */
+QSharedPointer<DocRoot> cachedParseDoc(const QString &fileName, int startLine, QSharedPointer<Definition> context,
+                  QSharedPointer<MemberDef> md, const QString &input, bool indexWords, bool isExample,
+                  const QString &exampleName = QString(), bool singleLine = false, bool linkFromIndex = false);
+
+/*! Prints the number of documentation blocks found in the cache used by cachedParseDoc */
+void printDocCacheStatistics();
+
 /*! Main entry point for parsing simple text fragments. These
  *  fragments are limited to words, whitespace and symbols.
  */
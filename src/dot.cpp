@@ -27,6 +27,7 @@
 #include <config.h>
 #include <default_args.h>
 #include <docparser.h>
+#include <dotcache.h>
 #include <doxy_globals.h>
 #include <groupdef.h>
 #include <language.h>
@@ -719,14 +720,15 @@ static bool checkDeliverables(const QString &file1, const QString &file2 = QStri
    bool file1Ok = true;
    bool file2Ok = true;
 
+   // dot may still be writing a file of a graph queued earlier
    if (! file1.isEmpty()) {
       QFileInfo fi(file1);
-      file1Ok = (fi.exists() && fi.size() > 0);
+      file1Ok = (fi.exists() && fi.size() > 0) && ! DotManager::instance()->isPending(file1);
    }
 
    if (! file2.isEmpty()) {
       QFileInfo fi(file2);
-      file2Ok = (fi.exists() && fi.size() > 0);
+      file2Ok = (fi.exists() && fi.size() > 0) && ! DotManager::instance()->isPending(file2);
    }
    return file1Ok && file2Ok;
 }
@@ -756,6 +758,9 @@ void DotRunner::addJob(const QString &format, const QString &output)
 {
    QString args = "-T" + format + " -o \"" + output + "\"";
    m_jobs.append(args);
+
+   m_formats.append(format);
+   m_outputs.append(output);
 }
 
 void DotRunner::addPostProcessing(const  QString &cmd, const  QString &args)
@@ -771,6 +776,15 @@ bool DotRunner::run()
    int exitCode = 0;
    QString dotArgs;
 
+   if (fetchCached()) {
+      return postProcess();
+   }
+
+   // an output may be linked to an entry of the graph cache, dot must not write into that file
+   for (const auto &output : m_outputs) {
+      QFile::remove(output);
+   }
+
    if (m_multiTargets) {
       dotArgs = "\"" + m_file + "\"";
 
@@ -793,6 +807,38 @@ bool DotRunner::run()
       }
    }
 
+   storeCached();
+
+   return postProcess();
+
+error:
+   std::lock_guard<std::mutex> lock(m_output_mutex);
+
+   if (logCount < 5) {
+
+      logCount++;
+
+      if (exitCode == -1) {
+         errAll("Unable to run '%s', most likely the Dot program was not found\n", csPrintable(m_dotExe));
+
+      } else  {
+         errNoPrefixAll("\n");
+         errAll("Unable to run '%s', exit code = %d\nArguments = '%s'\n", csPrintable(m_dotExe),
+                     exitCode, csPrintable(dotArgs));
+      }
+
+   } else if (logCount == 5) {
+
+      logCount++;
+      errNoPrefixAll("\n** Suppressing all further messages regarding dot program execution\n\n");
+
+   }
+
+   return false;
+}
+
+bool DotRunner::postProcess()
+{
    if (! m_postCmd.isEmpty() && portable_system(m_postCmd, m_postArgs) != 0) {
       std::lock_guard<std::mutex> lock(m_output_mutex);
 
@@ -810,31 +856,152 @@ bool DotRunner::run()
    }
 
    return true;
+}
 
-error:
-   std::lock_guard<std::mutex> lock(m_output_mutex);
+// true if the outputs were found in the graph cache and placed in the output directory
+bool DotRunner::fetchCached()
+{
+   DotGraphCache *graphCache = DotGraphCache::instance();
 
-   if (logCount < 5) {
+   if (! graphCache->isEnabled() || ! m_cacheKey.isEmpty()) {
+      // disabled or already looked up
+      return false;
+   }
 
-      logCount++;
+   m_cacheKey = graphCache->key(m_file, m_formats);
 
-      if (exitCode == -1) {
-         errAll("Unable to run '%s', most likely the Dot program was not found\n", csPrintable(m_dotExe));
+   return graphCache->fetch(m_cacheKey, m_outputs);
+}
 
-      } else  {
-         errNoPrefixAll("\n");
-         errAll("Unable to run '%s', exit code = %d\nArguments = '%s'\n", csPrintable(m_dotExe),
-                     exitCode, csPrintable(dotArgs));
+void DotRunner::storeCached()
+{
+   if (! m_cacheKey.isEmpty()) {
+      DotGraphCache::instance()->store(m_cacheKey, m_outputs);
+   }
+}
+
+void DotRunner::detachFile(int serial)
+{
+   QString detached = m_file + "." + QString::number(serial);
+
+   QFile::remove(detached);
+
+   if (QFile::rename(m_file, detached)) {
+      m_origFile = m_file;
+      m_file     = detached;
+   }
+}
+
+void DotRunner::restoreFile()
+{
+   if (m_cleanUp || m_origFile.isEmpty()) {
+      return;
+   }
+
+   // the original name may be used by a newer copy of the graph
+   if (! QFile::rename(m_file, m_origFile)) {
+      QFile::remove(m_file);
+   }
+}
+
+QString DotRunner::batchKey() const
+{
+   if (m_jobs.isEmpty() || (! m_multiTargets && m_jobs.count() > 1)) {
+      return QString();
+   }
+
+   // every file passed to one dot process is rendered in the same formats
+   return m_formats.join(' ');
+}
+
+// name of the file written by dot -O, the parts of the format are appended in reverse order
+static QString dotAutoOutputName(const QString &dotFile, const QString &format)
+{
+   QString retval = dotFile;
+   QStringList parts = format.split(':');
+
+   for (int i = parts.count() - 1; i >= 0; --i) {
+      retval += "." + parts[i];
+   }
+
+   return retval;
+}
+
+bool DotRunner::runBatch(const QList<DotRunner *> &runners)
+{
+   bool retval = true;
+
+   QList<DotRunner *> pending;
+
+   for (auto runner : runners) {
+      if (runner->fetchCached()) {
+         retval = runner->postProcess() && retval;
+      } else {
+         pending.append(runner);
       }
+   }
 
-   } else if (logCount == 5) {
+   if (pending.isEmpty()) {
+      return retval;
 
-      logCount++;
-      errNoPrefixAll("\n** Suppressing all further messages regarding dot program execution\n\n");
+   } else if (pending.count() == 1) {
+      return pending.first()->run() && retval;
 
    }
 
-   return false;
+   DotRunner *first = pending.first();
+   QString dotArgs;
+
+   for (const auto &format : first->m_formats) {
+      dotArgs += "-T" + format + " ";
+   }
+
+   dotArgs += "-O";
+
+   for (auto runner : pending) {
+      dotArgs += " \"" + runner->m_file + "\"";
+
+      // a file left by an earlier run must not be mistaken for the result
+      for (const auto &format : runner->m_formats) {
+         QFile::remove(dotAutoOutputName(runner->m_file, format));
+      }
+   }
+
+   // the exit code only reports the last failure, the results are checked for each graph
+   portable_system(first->m_dotExe, dotArgs, false);
+
+   for (auto runner : pending) {
+      bool done = true;
+
+      for (int i = 0; i < runner->m_formats.count(); ++i) {
+         QString autoName = dotAutoOutputName(runner->m_file, runner->m_formats[i]);
+         QFileInfo fi(autoName);
+
+         if (! fi.exists() || fi.size() == 0) {
+            QFile::remove(autoName);
+            done = false;
+
+            continue;
+         }
+
+         QFile::remove(runner->m_outputs[i]);
+
+         if (! QFile::rename(autoName, runner->m_outputs[i])) {
+            done = false;
+         }
+      }
+
+      if (done) {
+         runner->storeCached();
+         retval = runner->postProcess() && retval;
+
+      } else {
+         // run this graph by itself to report the error for the right file
+         retval = runner->run() && retval;
+      }
+   }
+
+   return retval;
 }
 
 DotFilePatcher::DotFilePatcher(const QString &patchFile)
@@ -1140,10 +1307,51 @@ void DotRunnerQueue::enqueue(DotRunner *runner)
 {
    QMutexLocker locker(&m_mutex);
 
+   if (runner != nullptr) {
+      for (const auto &item : runner->outputs()) {
+         m_pendingOutputs.insert(item);
+      }
+   }
+
    m_queue.enqueue(runner);
    m_bufferNotEmpty.wakeAll();
 }
 
+void DotRunnerQueue::finished(DotRunner *runner)
+{
+   QMutexLocker locker(&m_mutex);
+
+   for (const auto &item : runner->outputs()) {
+      m_pendingOutputs.remove(item);
+   }
+
+   ++m_finished;
+   m_runFinished.wakeAll();
+}
+
+uint DotRunnerQueue::waitForFinished(uint count)
+{
+   QMutexLocker locker(&m_mutex);
+
+   while (m_finished <= count) {
+      m_runFinished.wait(&m_mutex);
+   }
+
+   return m_finished;
+}
+
+uint DotRunnerQueue::finishedCount() const
+{
+   QMutexLocker locker(&m_mutex);
+   return m_finished;
+}
+
+bool DotRunnerQueue::isPending(const QString &fileName) const
+{
+   QMutexLocker locker(&m_mutex);
+   return m_pendingOutputs.contains(fileName);
+}
+
 DotRunner *DotRunnerQueue::dequeue()
 {
    QMutexLocker locker(&m_mutex);
@@ -1158,6 +1366,50 @@ DotRunner *DotRunnerQueue::dequeue()
    return result;
 }
 
+QList<DotRunner *> DotRunnerQueue::dequeueBatch(int maxCount)
+{
+   QList<DotRunner *> retval;
+
+   QMutexLocker locker(&m_mutex);
+
+   while (m_queue.isEmpty()) {
+      // wait until something is added to the queue
+      m_bufferNotEmpty.wait(&m_mutex);
+   }
+
+   DotRunner *first = m_queue.dequeue();
+
+   if (first == nullptr) {
+      // terminator
+      return retval;
+   }
+
+   retval.append(first);
+
+   QString key = first->batchKey();
+
+   if (key.isEmpty()) {
+      return retval;
+   }
+
+   // only look at the front of the queue, graphs are mostly queued in groups of the same type
+   int maxScan = 4 * maxCount;
+
+   for (int i = 0; i < m_queue.count() && i < maxScan && retval.count() < maxCount; ) {
+      DotRunner *runner = m_queue[i];
+
+      if (runner != nullptr && runner->batchKey() == key) {
+         retval.append(runner);
+         m_queue.removeAt(i);
+
+      } else {
+         ++i;
+      }
+   }
+
+   return retval;
+}
+
 uint DotRunnerQueue::count() const
 {
    QMutexLocker locker(&m_mutex);
@@ -1165,22 +1417,46 @@ uint DotRunnerQueue::count() const
 }
 
 
-DotWorkerThread::DotWorkerThread(DotRunnerQueue *queue)
-   : m_queue(queue)
+DotWorkerThread::DotWorkerThread(DotRunnerQueue *queue, int batchSize)
+   : m_queue(queue), m_batchSize(batchSize)
 {
 }
 
 void DotWorkerThread::run()
 {
+   if (m_batchSize > 1) {
+      QList<DotRunner *> runners;
+
+      while (! (runners = m_queue->dequeueBatch(m_batchSize)).isEmpty()) {
+         DotRunner::runBatch(runners);
+
+         for (auto runner : runners) {
+            runner->restoreFile();
+            DotRunner::CleanupItem cleanup = runner->cleanup();
+
+            if (! cleanup.file.isEmpty()) {
+               m_cleanupItems.append(cleanup);
+            }
+
+            m_queue->finished(runner);
+         }
+      }
+
+      return;
+   }
+
    DotRunner *runner;
 
    while ((runner = m_queue->dequeue())) {
       runner->run();
+      runner->restoreFile();
       DotRunner::CleanupItem cleanup = runner->cleanup();
 
       if (! cleanup.file.isEmpty()) {
          m_cleanupItems.append(cleanup);
       }
+
+      m_queue->finished(runner);
    }
 }
 
@@ -1202,11 +1478,16 @@ DotManager *DotManager::instance()
 }
 
 DotManager::DotManager()
+   : m_fontPathSet(false)
 {
    m_queue = new DotRunnerQueue;
 
+   // looks up the dot version before any worker thread uses the cache
+   DotGraphCache::instance();
+
    int i;
    int numThreads = qMin(32, Config::getInt("dot-num-threads"));
+   int batchSize  = Config::getInt("dot-batch-size");
 
    if (numThreads != 1) {
       if (numThreads == 0) {
@@ -1214,7 +1495,7 @@ DotManager::DotManager()
       }
 
       for (i = 0; i < numThreads; i++) {
-         DotWorkerThread *thread = new DotWorkerThread(m_queue);
+         DotWorkerThread *thread = new DotWorkerThread(m_queue, batchSize);
          thread->start();
 
          if (thread->isRunning()) {
@@ -1235,6 +1516,38 @@ DotManager::~DotManager()
 void DotManager::addRun(DotRunner *run)
 {
    m_dotRuns.append(run);
+
+   if (m_workers.count() > 0) {
+      // start dot while the remaining output is generated
+      if (! m_timer.isValid()) {
+         setFontPath();
+         m_timer.start();
+      }
+
+      run->detachFile(m_dotRuns.count());
+      m_queue->enqueue(run);
+   }
+}
+
+bool DotManager::isPending(const QString &fileName) const
+{
+   return m_queue->isPending(fileName);
+}
+
+void DotManager::setFontPath()
+{
+   if (Config::getBool("generate-html")) {
+      setDotFontPath(Config::getString("html-output"));
+      m_fontPathSet = true;
+
+   } else if (Config::getBool("generate-latex")) {
+      setDotFontPath(Config::getString("latex-output"));
+      m_fontPathSet = true;
+
+   } else if (Config::getBool("generate-rtf")) {
+      setDotFontPath(Config::getString("rtf-output"));
+      m_fontPathSet = true;
+   }
 }
 
 int DotManager::addMap(const QString &file, const QString &mapFile,
@@ -1303,26 +1616,15 @@ bool DotManager::run()
    }
 
    int i = 1;
-   bool setPath = false;
-
-   if (Config::getBool("generate-html")) {
-      setDotFontPath(Config::getString("html-output"));
-      setPath = true;
-
-   } else if (Config::getBool("generate-latex")) {
-      setDotFontPath(Config::getString("latex-output"));
-      setPath = true;
 
-   } else if (Config::getBool("generate-rtf")) {
-      setDotFontPath(Config::getString("rtf-output"));
-      setPath = true;
+   if (! m_timer.isValid()) {
+      setFontPath();
+      m_timer.start();
    }
 
    portable_sysTimerStart();
 
-   // fill work queue with dot operations
-   DotRunner *dr;
-   int prev = 1;
+   uint prev = 1;
 
    if (m_workers.count() == 0) {
       // no threads to work with
@@ -1334,25 +1636,21 @@ bool DotManager::run()
       }
 
    } else {
-      // use multiple threads to run instances of dot in parallel
-      for (auto dr : m_dotRuns) {
-         m_queue->enqueue(dr);
+      // runs were queued by addRun() and may be partially done
+      uint finished = m_queue->finishedCount();
+
+      if (finished > 0) {
+         msg("Dot finished %d of %d graphs while generating the output\n", finished, numDotRuns);
+         prev = finished + 1;
       }
 
-      // wait for the queue to become empty
-      while ((i = m_queue->count()) > 0) {
-         i = numDotRuns - i;
+      while (finished < numDotRuns) {
+         finished = m_queue->waitForFinished(finished);
 
-         while (i >= prev) {
+         while (finished >= prev) {
             msg("Running dot for graph %d/%d\n", prev, numDotRuns);
             prev++;
          }
-         portable_sleep(100);
-      }
-
-      while (numDotRuns >= prev) {
-         msg("Running dot for graph %d/%d\n", prev, numDotRuns);
-         prev++;
       }
 
       // signal the workers we are done
@@ -1371,10 +1669,21 @@ bool DotManager::run()
       }
    }
    portable_sysTimerStop();
-   if (setPath) {
+
+   if (m_fontPathSet) {
       unsetDotFontPath();
+      m_fontPathSet = false;
+   }
+
+   if (numDotRuns > 0) {
+      double seconds = m_timer.elapsed() / 1000.0;
+
+      msg("Generated %d dot graphs in %.2f seconds, %.1f graphs per second\n", numDotRuns, seconds,
+            seconds > 0 ? numDotRuns / seconds : 0.0);
    }
 
+   DotGraphCache::instance()->evict();
+
    // patch the output file and insert the maps and figures
    i = 1;
 
@@ -20,10 +20,13 @@
 #define DOT_H
 
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QList>
 #include <QHash>
 #include <QMutex>
 #include <QQueue>
+#include <QSet>
+#include <QStringList>
 #include <QTextStream>
 #include <QThread>
 #include <QWaitCondition>
@@ -383,12 +386,41 @@ class DotRunner
    /** Runs dot for all jobs added. */
    bool run();
 
+   /** Returns a key which is equal for runners which can be passed to the same dot process,
+    *  empty if this runner can only be run by itself.
+    */
+   QString batchKey() const;
+
+   /** Runs one dot process for all \a runners, which have the same batchKey(). A runner whose output
+    *  is missing afterwards is run by itself, so errors are reported for the right graph.
+    */
+   static bool runBatch(const QList<DotRunner *> &runners);
+
    CleanupItem cleanup() const {
       return m_cleanupItem;
    }
 
+   QStringList outputs() const {
+      return m_outputs;
+   }
+
+   /** Renames the dot file so a graph written while dot is running can not change it */
+   void detachFile(int serial);
+
+   /** Moves a detached dot file back to its original name when it is not cleaned up */
+   void restoreFile();
+
  private:
+   bool fetchCached();
+   void storeCached();
+   bool postProcess();
+
    QList<QString> m_jobs;
+   QList<QString> m_formats;
+   QList<QString> m_outputs;
+
+   QString m_cacheKey;
+   QString m_origFile;
 
    QString m_postArgs;
    QString m_postCmd;
@@ -442,11 +474,31 @@ class DotRunnerQueue
  public:
    void enqueue(DotRunner *runner);
    DotRunner *dequeue();
+
+   /** Waits for a runner and removes up to \a maxCount queued runners with the same batch key,
+    *  returns an empty list for a terminator.
+    */
+   QList<DotRunner *> dequeueBatch(int maxCount);
+
    uint count() const;
 
+   /** Called by a worker when \a runner is done */
+   void finished(DotRunner *runner);
+
+   /** Waits until more than \a count runners are done, returns the number of runners done */
+   uint waitForFinished(uint count);
+
+   uint finishedCount() const;
+
+   /** Returns true if \a fileName is an output of a runner which is not done */
+   bool isPending(const QString &fileName) const;
+
  private:
    QWaitCondition  m_bufferNotEmpty;
+   QWaitCondition  m_runFinished;
    QQueue<DotRunner *> m_queue;
+   QSet<QString>   m_pendingOutputs;
+   uint            m_finished = 0;
    mutable QMutex  m_mutex;
 };
 
@@ -454,12 +506,13 @@ class DotRunnerQueue
 class DotWorkerThread : public QThread
 {
  public:
-   DotWorkerThread(DotRunnerQueue *queue);
+   DotWorkerThread(DotRunnerQueue *queue, int batchSize = 1);
    void run() override;
    void cleanup();
 
  private:
    DotRunnerQueue *m_queue;
+   int m_batchSize;
    QList<DotRunner::CleanupItem> m_cleanupItems;
 };
 
@@ -480,14 +533,22 @@ class DotManager
 
    int addSVGObject(const QString &file, const QString &baseName, const QString &figureName, const QString &relPath);
 
+   /** Returns true if \a fileName will be written by a dot run which is queued or running */
+   bool isPending(const QString &fileName) const;
+
    bool run();
 
  private:
    DotManager();
    virtual ~DotManager();
 
+   void setFontPath();
+
    QList<DotRunner *> m_dotRuns;
 
+   bool m_fontPathSet;
+   QElapsedTimer m_timer;
+
    StringMap<QSharedPointer<DotFilePatcher>> m_dotMaps;
 
    static DotManager        *m_theInstance;
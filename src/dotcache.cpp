@@ -0,0 +1,244 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QMultiMap>
+#include <QProcess>
+
+#include <dotcache.h>
+
+#include <config.h>
+#include <message.h>
+#include <portable.h>
+
+DotGraphCache::DotGraphCache()
+   : m_maxSize(0), m_hits(0), m_misses(0), m_stored(0), m_evicted(0)
+{
+   m_cacheDir = Config::getString("dot-cache-dir");
+
+   if (m_cacheDir.isEmpty()) {
+      return;
+   }
+
+   if (! QDir::isAbsolutePath(m_cacheDir)) {
+      m_cacheDir.prepend(Config::getString("output-dir") + "/");
+   }
+
+   if (! QDir().mkpath(m_cacheDir)) {
+      warn_uncond("Unable to create dot cache directory %s, cache disabled\n", csPrintable(m_cacheDir));
+      m_cacheDir = QString();
+
+      return;
+   }
+
+   m_maxSize = qint64(Config::getInt("dot-cache-size")) * 1024 * 1024;
+
+   // a different version of dot may render the same graph differently
+   QString dotExe = Config::getString("dot-path");
+
+   QProcess dotProcess;
+   dotProcess.start(dotExe, QStringList() << "-V");
+   dotProcess.waitForFinished(-1);
+
+   m_dotVersion  = dotExe.toUtf8() + "\n";
+   m_dotVersion += dotProcess.readAllStandardError().trimmed() + "\n";
+   m_dotVersion += Config::getString("dot-font-path").toUtf8();
+}
+
+DotGraphCache *DotGraphCache::instance()
+{
+   static DotGraphCache retval;
+   return &retval;
+}
+
+QString DotGraphCache::key(const QString &dotFile, const QStringList &formats) const
+{
+   QFile file(dotFile);
+
+   if (! file.open(QIODevice::ReadOnly)) {
+      return QString();
+   }
+
+   QCryptographicHash hash(QCryptographicHash::Md5);
+
+   hash.addData(m_dotVersion);
+   hash.addData(formats.join(' ').toUtf8());
+   hash.addData("\n", 1);
+   hash.addData(file.readAll());
+
+   return QString::fromLatin1(hash.result().toHex());
+}
+
+QString DotGraphCache::entryName(const QString &key, int index) const
+{
+   return m_cacheDir + "/" + key + "." + QString::number(index);
+}
+
+// links target to source, copies the file if the file system does not support links
+static bool linkOrCopy(const QString &source, const QString &target)
+{
+   QFile::remove(target);
+
+   if (portable_linkFile(source, target)) {
+      return true;
+   }
+
+   return QFile::copy(source, target);
+}
+
+bool DotGraphCache::fetch(const QString &key, const QStringList &outputs)
+{
+   if (key.isEmpty()) {
+      return false;
+   }
+
+   QMutexLocker locker(&m_mutex);
+
+   for (int i = 0; i < outputs.count(); ++i) {
+      if (! QFile::exists(entryName(key, i))) {
+         ++m_misses;
+         return false;
+      }
+   }
+
+   for (int i = 0; i < outputs.count(); ++i) {
+      QString fileName = entryName(key, i);
+
+      if (! linkOrCopy(fileName, outputs[i])) {
+         ++m_misses;
+         return false;
+      }
+
+      // modification time is used as the time of last use when evicting
+      portable_touchFile(fileName);
+   }
+
+   ++m_hits;
+
+   return true;
+}
+
+void DotGraphCache::store(const QString &key, const QStringList &outputs)
+{
+   if (key.isEmpty()) {
+      return;
+   }
+
+   QMutexLocker locker(&m_mutex);
+
+   for (int i = 0; i < outputs.count(); ++i) {
+      QFileInfo fi(outputs[i]);
+
+      if (! fi.exists() || fi.size() == 0) {
+         return;
+      }
+   }
+
+   for (int i = 0; i < outputs.count(); ++i) {
+      QString fileName = entryName(key, i);
+      QString tmpName  = fileName + ".tmp";
+
+      // copy since the output may be written again, rename so a partially written file is never used
+      QFile::remove(tmpName);
+
+      if (! QFile::copy(outputs[i], tmpName)) {
+         QFile::remove(tmpName);
+         return;
+      }
+
+      QFile::remove(fileName);
+
+      if (! QFile::rename(tmpName, fileName)) {
+         QFile::remove(tmpName);
+         return;
+      }
+   }
+
+   ++m_stored;
+}
+
+void DotGraphCache::evict()
+{
+   if (! isEnabled() || m_maxSize <= 0) {
+      return;
+   }
+
+   QMutexLocker locker(&m_mutex);
+
+   struct CacheEntry {
+      QStringList fileNames;
+      QDateTime   lastUsed;
+      qint64      size = 0;
+   };
+
+   QMap<QString, CacheEntry> entries;
+   qint64 totalSize = 0;
+
+   const QFileInfoList fileList = QDir(m_cacheDir).entryInfoList(QDir::Files);
+
+   for (const auto &fi : fileList) {
+      // key.index, all files of an entry are removed together
+      CacheEntry &entry = entries[fi.completeBaseName()];
+
+      entry.fileNames.append(fi.absoluteFilePath());
+      entry.size += fi.size();
+
+      if (entry.lastUsed.isNull() || fi.lastModified() > entry.lastUsed) {
+         entry.lastUsed = fi.lastModified();
+      }
+
+      totalSize += fi.size();
+   }
+
+   if (totalSize <= m_maxSize) {
+      return;
+   }
+
+   QMultiMap<QDateTime, QString> byLastUse;
+
+   for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+      byLastUse.insert(iter.value().lastUsed, iter.key());
+   }
+
+   for (auto iter = byLastUse.begin(); iter != byLastUse.end() && totalSize > m_maxSize; ++iter) {
+      const CacheEntry &entry = entries[iter.value()];
+
+      for (const auto &fileName : entry.fileNames) {
+         QFile::remove(fileName);
+      }
+
+      totalSize -= entry.size;
+      ++m_evicted;
+   }
+}
+
+void DotGraphCache::printStatistics() const
+{
+   if (isEnabled()) {
+      QMutexLocker locker(&m_mutex);
+
+      msg("Dot graph cache: %d graphs reused, %d graphs rendered, %d graphs stored, %d graphs removed\n",
+            m_hits, m_misses, m_stored, m_evicted);
+   }
+}
@@ -0,0 +1,78 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#ifndef DOTCACHE_H
+#define DOTCACHE_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+/** Cache of the images and maps rendered by dot, shared by all output directories and runs.
+ *
+ *  The key is a hash of the contents of the dot file, the output formats and the dot version.
+ *  Equal graphs produce equal files, so the result is linked or copied to the requested
+ *  location instead of running dot. Entries are copies of the rendered files and are never
+ *  written again, outputs are removed before dot runs so a linked entry is not overwritten.
+ *  The least recently used entries are removed when the size of the cache directory exceeds
+ *  dot-cache-size.
+ */
+class DotGraphCache
+{
+ public:
+   static DotGraphCache *instance();
+
+   bool isEnabled() const {
+      return ! m_cacheDir.isEmpty();
+   }
+
+   /** Returns the key for the given dot file rendered in the given formats */
+   QString key(const QString &dotFile, const QStringList &formats) const;
+
+   /** Places the cached files for \a key at \a outputs, returns false if the key is not in the cache */
+   bool fetch(const QString &key, const QStringList &outputs);
+
+   /** Adds the files produced by dot for \a key */
+   void store(const QString &key, const QStringList &outputs);
+
+   /** Removes the least recently used entries until the cache is smaller than dot-cache-size */
+   void evict();
+
+   void printStatistics() const;
+
+ private:
+   DotGraphCache();
+
+   QString entryName(const QString &key, int index) const;
+
+   QString    m_cacheDir;
+   QByteArray m_dotVersion;
+   qint64     m_maxSize;
+
+   int m_hits;
+   int m_misses;
+   int m_stored;
+   int m_evicted;
+
+   mutable QMutex m_mutex;
+};
+
+#endif
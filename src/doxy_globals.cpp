@@ -16,9 +16,17 @@
 *
 *************************************************************************/
 
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+
 #include <doxy_globals.h>
 #include <doxy_build_info.h>
 #include <filedef.h>
+#include <portable.h>
 
 class GenericsSDict;
 class IndexList;
@@ -84,7 +92,7 @@ QHash<QString, QSharedPointer<Definition>>   Doxy_Globals::clangUsrMap;
 QHash<long, QSharedPointer<MemberGroupInfo>> Doxy_Globals::memGrpInfoDict;    // dictionary of the member groups heading
 
 StringMap<QSharedPointer<DirRelation>>       Doxy_Globals::dirRelations;
-QCache<QString, LookupInfo>                  Doxy_Globals::lookupCache;
+QCache<LookupKey, LookupInfo>                Doxy_Globals::lookupCache;
 
 QString Doxy_Globals::htmlFileExtension;
 QString Doxy_Globals::latexStyleExtension = ".sty";
@@ -108,6 +116,9 @@ int Doxy_Globals::documentedPages;
 int Doxy_Globals::indexedPages;
 int Doxy_Globals::subpageNestingLevel;
 
+int Doxy_Globals::lookupCacheHits   = 0;
+int Doxy_Globals::lookupCacheMisses = 0;
+
 QDateTime Doxy_Globals::dateTime;
 
 QHash<QString, QSharedPointer<Entry>> Doxy_Globals::g_classEntries;
@@ -119,8 +130,99 @@ QSet<QString>             Doxy_Globals::g_pathsVisited;
 
 QMap<QString, QString>    Doxy_Globals::g_moduleHint;               // experimental
 
-QMultiHash<QString, Definition *>  &Doxy_Globals::glossary()
+SymbolTable &Doxy_Globals::glossary()
 {
-   static QMultiHash<QString, Definition *> data;
+   static SymbolTable data;
    return data;
 }
+
+void Statistics::begin(const QString &name)
+{
+   msg(name);
+
+   if (m_active) {
+      // previous phase was not closed
+      end();
+   }
+
+   if (! m_totalTimer.isValid()) {
+      m_totalTimer.start();
+   }
+
+   m_name     = name.trimmed();
+   m_active   = true;
+   m_cpuStart = portable_getCpuTime();
+
+   m_timer.start();
+}
+
+void Statistics::end()
+{
+   if (! m_active) {
+      return;
+   }
+
+   Phase phase;
+
+   phase.name       = m_name;
+   phase.wallTime   = m_timer.elapsed();
+   phase.cpuTime    = portable_getCpuTime() - m_cpuStart;
+   phase.peakMemory = portable_getPeakMemory();
+
+   m_phases.append(phase);
+   m_active = false;
+}
+
+void Statistics::print() const
+{
+   QVector<Phase> phases = m_phases;
+
+   std::stable_sort(phases.begin(), phases.end(), [] (const Phase &a, const Phase &b) {
+      return a.wallTime > b.wallTime;
+   });
+
+   msg("\n**  Statistics\n");
+   msg("%10s %10s %12s   %s\n", "wall (s)", "cpu (s)", "peak (MB)", "phase");
+
+   for (const auto &item : phases) {
+      msg("%10.3f %10.3f %12.1f   %s\n", item.wallTime / 1000.0, item.cpuTime,
+            item.peakMemory / (1024.0 * 1024.0), csPrintable(item.name));
+   }
+
+   msg("%10.3f %10.3f %12.1f   %s\n\n", m_totalTimer.elapsed() / 1000.0, portable_getCpuTime(),
+            portable_getPeakMemory() / (1024.0 * 1024.0), "Total");
+}
+
+bool Statistics::writeJson(const QString &fileName) const
+{
+   QJsonArray list;
+
+   for (const auto &item : m_phases) {
+      QJsonObject object;
+
+      object.insert("phase",       item.name);
+      object.insert("wall-ms",     double(item.wallTime));
+      object.insert("cpu-sec",     item.cpuTime);
+      object.insert("peak-bytes",  double(item.peakMemory));
+
+      list.append(object);
+   }
+
+   QJsonObject root;
+   root.insert("phases",            list);
+   root.insert("total-wall-ms",     double(m_totalTimer.elapsed()));
+   root.insert("total-cpu-sec",     portable_getCpuTime());
+   root.insert("total-peak-bytes",  double(portable_getPeakMemory()));
+
+   QFile f(fileName);
+
+   if (! f.open(QIODevice::WriteOnly)) {
+      err("Unable to open file for writing %s, error: %d\n", csPrintable(fileName), f.error());
+      return false;
+   }
+
+   f.write(QJsonDocument(root).toJson());
+   f.close();
+
+   return true;
+}
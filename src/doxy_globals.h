@@ -21,12 +21,14 @@
 
 #include <QByteArray>
 #include <QCache>
+#include <QElapsedTimer>
 #include <QHash>
-#include <QMultiHash>
 #include <QList>
+#include <QPair>
 #include <QString>
 #include <QSharedPointer>
 #include <QTime>
+#include <QVector>
 
 #include <classlist.h>
 #include <cite.h>
@@ -44,6 +46,7 @@
 #include <reflist.h>
 #include <searchindex.h>
 #include <stringmap.h>
+#include <symboltable.h>
 
 struct LookupInfo {
    LookupInfo() {}
@@ -59,6 +62,9 @@ struct LookupInfo {
    QString resolvedType;
 };
 
+// symbol ids of the scope, the name, the explicit scope and the file scope of a lookup, -1 when not used
+using LookupKey = QPair<QPair<int, int>, QPair<int, int>>;
+
 class StringDict : public QHash<QString, QString>
 {
  public:
@@ -69,19 +75,40 @@ class StringDict : public QHash<QString, QString>
    {}
 };
 
+/** Records the wall time, processor time and peak memory of each processing phase */
 class Statistics
 {
  public:
    Statistics()
+      : m_active(false), m_cpuStart(0.0)
    {}
 
-   void begin(const QString &name) {
-      msg(name);
-   }
+   void begin(const QString &name);
+   void end();
+
+   /** Prints the recorded phases sorted by elapsed time */
+   void print() const;
+
+   /** Writes the recorded phases to \a fileName in JSON format */
+   bool writeJson(const QString &fileName) const;
+
+ private:
+   struct Phase {
+      QString name;
 
-   void end() {
-   }
+      qint64 wallTime;         // milliseconds
+      double cpuTime;          // seconds
+      qint64 peakMemory;       // bytes
+   };
 
+   QVector<Phase> m_phases;
+   QString        m_name;
+
+   QElapsedTimer  m_timer;
+   QElapsedTimer  m_totalTimer;
+
+   bool   m_active;
+   double m_cpuStart;
 };
 
 namespace Doxy_Work{
@@ -156,7 +183,7 @@ class Doxy_Globals
       static QHash<long, QSharedPointer<MemberGroupInfo>> memGrpInfoDict;
 
       static StringMap<QSharedPointer<DirRelation>>       dirRelations;
-      static QCache<QString, LookupInfo>                  lookupCache;
+      static QCache<LookupKey, LookupInfo>                lookupCache;
 
       static QString htmlFileExtension;
       static QString latexStyleExtension;
@@ -180,6 +207,9 @@ class Doxy_Globals
       static int indexedPages;
       static int subpageNestingLevel;
 
+      static int lookupCacheHits;
+      static int lookupCacheMisses;
+
       static QDateTime dateTime;
 
       static QHash<QString, QSharedPointer<Entry>>  g_classEntries;
@@ -191,7 +221,7 @@ class Doxy_Globals
       static QHash<QString, FileDef>   g_usingDeclarations;
 
       // must use a raw pointer since this method is called from a constructor
-      static QMultiHash<QString, Definition *> &glossary();
+      static SymbolTable &glossary();
 };
 
 #endif
\ No newline at end of file
@@ -17,6 +17,7 @@
 *************************************************************************/
 
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QTextCodec>
 #include <QTextStream>
 
@@ -54,10 +55,14 @@
 #include <portable.h>
 #include <pre.h>
 #include <rtfgen.h>
+#include <searchindex.h>
+#include <searchmap.h>
 #include <util.h>
 
 namespace Doxy_Setup {
    QString getValue(QStringList::iterator &iter, QStringList::iterator end);
+   void querySearchIndex(const QString &indexName, const QString &text);
+   void mergeSearchIndex(const QString &outputName, const QStringList &fileNames);
    void usage();
 }
 
@@ -72,6 +77,8 @@ enum Options {
      DATETIME,
      HELP,
      OUTPUT_APP,
+     SEARCH_QUERY,
+     SEARCH_MERGE,
      DVERSION,
 };
 
@@ -152,10 +159,12 @@ struct CommandLine parseCommandLine(QStringList argList)
    argMap.insert( "--h",       HELP            );
    argMap.insert( "--l",       BLANK_LAYOUT    );
    argMap.insert( "--m",       DEBUG_SYMBOLS   );
+   argMap.insert( "--s",       SEARCH_QUERY    );
    argMap.insert( "--w",       BLANK_STYLE     );
    argMap.insert( "--v",       DVERSION        );
    argMap.insert( "--dt",      DATETIME        );
    argMap.insert( "--help",    HELP            );
+   argMap.insert( "--merge",   SEARCH_MERGE    );
    argMap.insert( "--version", DVERSION        );
 
    QStringList dashList;
@@ -354,6 +363,41 @@ struct CommandLine parseCommandLine(QStringList argList)
             cmdArgs.dateTimeStr = getValue(iter, argList.end());
             break;
 
+         case SEARCH_QUERY:
+            {
+               QString indexName = getValue(iter, argList.end());
+               QString text      = getValue(iter, argList.end());
+
+               if (indexName.isEmpty() || text.isEmpty()) {
+                  err("Option \"-s\" is missing the search index file name or the words to find\n");
+                  Doxy_Work::stopDoxyPress();
+               }
+
+               querySearchIndex(indexName, text);
+               exit(0);
+            }
+
+         case SEARCH_MERGE:
+            {
+               QStringList fileNames;
+               QString name = getValue(iter, argList.end());
+
+               while (! name.isEmpty()) {
+                  fileNames.append(name);
+                  name = getValue(iter, argList.end());
+               }
+
+               if (fileNames.count() < 2) {
+                  err("Option \"--merge\" is missing the output name or the search indexes to merge\n");
+                  Doxy_Work::stopDoxyPress();
+               }
+
+               QString outputName = fileNames.takeFirst();
+
+               mergeSearchIndex(outputName, fileNames);
+               exit(0);
+            }
+
          case HELP:
             usage();
             exit(0);
@@ -654,6 +698,115 @@ SrcLangExt getLanguageFromFileName(const QString &fileName)
    return SrcLangExt_Cpp;    // not listed, assume C language
 }
 
+void Doxy_Setup::querySearchIndex(const QString &indexName, const QString &text)
+{
+   SearchMap index;
+
+   if (! index.open(indexName)) {
+      err("Unable to open search index %s\n", csPrintable(indexName));
+      Doxy_Work::stopDoxyPress();
+   }
+
+   QElapsedTimer timer;
+   timer.start();
+
+   QVector<SearchMap::Match> matches = index.query(text);
+   qint64 elapsed = timer.nsecsElapsed();
+
+   for (const auto &item : matches) {
+      SearchMap::Document doc = index.document(item.urlIdx);
+      printf("%s\n   %s (%d)\n", csPrintable(doc.name), csPrintable(doc.url), item.freq);
+   }
+
+   printf("\n%d matches in %d documents, %.1f us\n", matches.count(), index.documentCount(), elapsed / 1000.0);
+}
+
+void Doxy_Setup::mergeSearchIndex(const QString &outputName, const QStringList &fileNames)
+{
+   QElapsedTimer timer;
+   timer.start();
+
+   if (outputName.endsWith(".xml", Qt::CaseInsensitive)) {
+      // external search data, the documents are copied since each one carries the tag of its project
+      QByteArray buffer = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<add>\n";
+
+      for (const auto &fileName : fileNames) {
+         QFile f(fileName);
+
+         if (! f.open(QIODevice::ReadOnly)) {
+            err("Unable to open search data file %s, error: %d\n", csPrintable(fileName), f.error());
+            Doxy_Work::stopDoxyPress();
+         }
+
+         QByteArray data = f.readAll();
+
+         int start = data.indexOf("<add>");
+         int end   = data.lastIndexOf("</add>");
+
+         if (start == -1 || end < start) {
+            err("Search data file %s is damaged\n", csPrintable(fileName));
+            Doxy_Work::stopDoxyPress();
+         }
+
+         start += 5;
+
+         while (start < end && (data[start] == '\n' || data[start] == '\r')) {
+            ++start;
+         }
+
+         buffer.append(data.constData() + start, end - start);
+      }
+
+      buffer.append("</add>\n");
+
+      QFile f(outputName);
+
+      if (! f.open(QIODevice::WriteOnly) || f.write(buffer) != buffer.size()) {
+         err("Unable to write search data file %s, error: %d\n", csPrintable(outputName), f.error());
+         Doxy_Work::stopDoxyPress();
+      }
+
+      printf("Merged %d search data files in %d ms\n", fileNames.count(), int(timer.elapsed()));
+      return;
+   }
+
+   // urls are relative to the html directory of each project, which is the parent of its search directory
+   QDir outputDir(outputName);
+   QString outputHtmlDir = QFileInfo(outputDir.absolutePath()).absolutePath();
+
+   if (! outputDir.mkpath(".")) {
+      err("Unable to create search index directory %s\n", csPrintable(outputName));
+      Doxy_Work::stopDoxyPress();
+   }
+
+   QStringList urlPrefixes;
+
+   for (const auto &fileName : fileNames) {
+      QString htmlDir = QFileInfo(QFileInfo(fileName).absolutePath()).absolutePath();
+      QString prefix  = QDir(outputHtmlDir).relativeFilePath(htmlDir);
+
+      if (prefix.isEmpty() || prefix == ".") {
+         urlPrefixes.append(QString());
+      } else {
+         urlPrefixes.append(prefix + "/");
+      }
+   }
+
+   QVector<SearchMap::Word> words;
+   QVector<SearchMap::Document> docs;
+
+   if (! SearchMap::merge(fileNames, urlPrefixes, words, docs)) {
+      Doxy_Work::stopDoxyPress();
+   }
+
+   if (writeSearchIndex(outputDir.absoluteFilePath("search.idx"), words, docs) < 0) {
+      Doxy_Work::stopDoxyPress();
+   }
+
+   printf("Merged %d search indexes, %d words, %d documents in %d ms\n", fileNames.count(), words.count(),
+         docs.count(), int(timer.elapsed()));
+}
+
 void Doxy_Setup::usage()
 {
    printf("\n");
@@ -686,6 +839,15 @@ void Doxy_Setup::usage()
    printf("Use the passed date/time value in the documentation:\n");
    printf("   --dt  [date_time]   Default is current date and time\n");
 
+   printf("\n\n");
+   printf("Search the server side search index written to html/search/search.map:\n");
+   printf("   --s  <index file name> <words>   Documents must contain every word, words are matched as prefixes\n");
+
+   printf("\n\n");
+   printf("Merge the search indexes of several projects, for example projects linked with tag files:\n");
+   printf("   --merge  <output search directory> <search.map file names>    Writes search.idx and search.map\n");
+   printf("   --merge  <output xml file name> <searchdata.xml file names>   Merges the external search data\n");
+
    printf("\n");
    printf("Other Options:\n");
    printf("   --h  display usage\n");
@@ -16,6 +16,8 @@
 *
 *************************************************************************/
 
+#include <QThread>
+
 #include <errno.h>
 #include <locale.h>
 #include <stdio.h>
@@ -37,17 +39,23 @@
 #include <docparser.h>
 #include <docsets.h>
 #include <dot.h>
+#include <dotcache.h>
 #include <doxy_setup.h>
 #include <doxy_globals.h>
 #include <eclipsehelp.h>
 #include <entry.h>
+#include <entrycache.h>
+#include <filecache.h>
 #include <formula.h>
 #include <ftvhelp.h>
 #include <groupdef.h>
 #include <htags.h>
 #include <htmlgen.h>
 #include <htmlhelp.h>
+#include <image.h>
+#include <includeresolver.h>
 #include <index.h>
+#include <input_queue.h>
 #include <language.h>
 #include <latexgen.h>
 #include <layout.h>
@@ -355,10 +363,13 @@ namespace Doxy_Work{
    void organizeSubGroups(QSharedPointer<Entry> ptrEntry);
 
    void parseFile(ParserInterface *parser, QSharedPointer<Entry> ptrEntry,
-                  QSharedPointer<FileDef> fd, QString fileName, enum ParserMode mode, QStringList &filesInSameTu);
+                  QSharedPointer<FileDef> fd, QString fileName, enum ParserMode mode, QStringList &filesInSameTu,
+                  InputFileQueue *readQueue = nullptr, int queueIndex = -1);
 
    void parseFiles(QSharedPointer<Entry> ptrEntry);
 
+   void prefetchTranslationUnits(const QStringList &fileList, int &nextIndex, int currentIndex);
+
    void processFiles();
    void processTagLessClasses(QSharedPointer<ClassDef> rootCd, QSharedPointer<ClassDef> cd, QSharedPointer<ClassDef>tagParentCd,
                   const QString &prefix, int count);
@@ -628,6 +639,7 @@ void processFiles()
    // calling buildClassList may result in cached relations which become invalid
    // after resolveClassNestingRelations(), that is why we clear the cache here
    Doxy_Globals::lookupCache.clear();
+   clearArgumentMatchCache();
 
    // we do not need the list of using declaration anymore
    Doxy_Globals::g_usingDeclarations.clear();
@@ -1061,20 +1073,17 @@ void generateOutput()
    writeTagFile();
    Doxy_Globals::infoLog_Stat.end();
 
-   if (Config::getBool("dot-cleanup")) {
-      if (generateHtml) {
-         removeDoxFont(htmlOutput);
-      }
-
-      if (generateRtf) {
-         removeDoxFont(Config::getString("rtf-output"));
-      }
-
-      if (generateLatex) {
-         removeDoxFont(Config::getString("latex-output"));
-      }
+   if (Config::getBool("output-async-write")) {
+      // pages are read back by the post processing steps
+      Doxy_Globals::infoLog_Stat.begin("Waiting for output files to be written\n");
+      OutputFileWriter::instance()->waitForFinished();
+      Doxy_Globals::infoLog_Stat.end();
    }
 
+   Doxy_Globals::infoLog_Stat.begin("Waiting for diagram images to be written\n");
+   ImageWriter::instance()->finish();
+   Doxy_Globals::infoLog_Stat.end();
+
    if (generateXml) {
       Doxy_Globals::infoLog_Stat.begin("Generating XML output\n");
 
@@ -1144,6 +1153,21 @@ void generateOutput()
       Doxy_Globals::infoLog_Stat.end();
    }
 
+   // dot runs started while the pages were generated use the font, remove it when all runs are done
+   if (Config::getBool("dot-cleanup")) {
+      if (generateHtml) {
+         removeDoxFont(htmlOutput);
+      }
+
+      if (generateRtf) {
+         removeDoxFont(Config::getString("rtf-output"));
+      }
+
+      if (generateLatex) {
+         removeDoxFont(Config::getString("latex-output"));
+      }
+   }
+
    // copy static files
    if (generateHtml)     {
       FTVHelp::generateTreeViewImages();
@@ -1205,7 +1229,34 @@ void generateOutput()
       Doxy_Globals::infoLog_Stat.end();
    }
 
-   msg("Lookup cache used %d/%d \n", Doxy_Globals::lookupCache.count(), Doxy_Globals::lookupCache.size());
+   msg("Lookup cache used %d/%d, %d hits, %d misses, %d symbols\n", Doxy_Globals::lookupCache.count(),
+                  Doxy_Globals::lookupCache.maxCost(), Doxy_Globals::lookupCacheHits, Doxy_Globals::lookupCacheMisses,
+                  Doxy_Globals::glossary().count());
+   printDocCacheStatistics();
+   printArgumentMatchStatistics();
+   FileContentCache::instance()->evict();
+   FileContentCache::instance()->printStatistics();
+   printPreprocessorStatistics();
+   IncludeResolver::instance()->printStatistics();
+   EntryCache::instance()->printStatistics();
+   DotGraphCache::instance()->printStatistics();
+   ImageWriter::instance()->printStatistics();
+
+   if (Config::getBool("statistics-summary")) {
+      Doxy_Globals::infoLog_Stat.print();
+   }
+
+   QString statisticsFile = Config::getString("statistics-file");
+
+   if (! statisticsFile.isEmpty()) {
+
+      if (! QDir::isAbsolutePath(statisticsFile)) {
+         statisticsFile.prepend(Config::getString("output-dir") + "/");
+      }
+
+      Doxy_Globals::infoLog_Stat.writeJson(statisticsFile);
+   }
+
    msg("Finished\n");
 
    // all done, cleaning up and exit
@@ -8212,12 +8263,21 @@ void Doxy_Work::generateSourceCode()
          QSet<QString> processedFiles;
          QSet<QString> filesToProcess;
 
+         QStringList sourceFiles;
+
          for (auto &fn : Doxy_Globals::inputNameList) {
             for (auto fd : *fn) {
                filesToProcess.insert(fd->getFilePath());
+
+               if (fd->isSource() && ! fd->isReference()) {
+                  sourceFiles.append(fd->getFilePath());
+               }
             }
          }
 
+         int sourceIndex = -1;
+         int nextIndex   = 0;
+
          // process source files (and their include dependencies)
          for (auto &fn : Doxy_Globals::inputNameList) {
 
@@ -8225,6 +8285,9 @@ void Doxy_Work::generateSourceCode()
                if (fd->isSource() && ! fd->isReference()) {
                   QStringList includeFiles;
 
+                  ++sourceIndex;
+                  prefetchTranslationUnits(sourceFiles, nextIndex, sourceIndex);
+
                   fd->getAllIncludeFilesRecursively(includeFiles);
                   fd->startParsing();
 
@@ -8302,8 +8365,28 @@ void Doxy_Work::generateSourceCode()
             }
          }
 
+         ClangParser::instance()->finishPrefetch();
+
       } else {
          // use lex and not clang
+         static const bool filterSourceFiles = Config::getBool("filter-source-files");
+         static const int numThreads         = Config::getInt("parse-num-threads");
+
+         QStringList fileList;
+
+         for (auto &fn : Doxy_Globals::inputNameList) {
+            for (auto fd : *fn) {
+               if (fd->generateSourceFile() || (! fd->isReference() && Doxy_Globals::parseSourcesNeeded)) {
+                  fileList.append(fd->getFilePath());
+               }
+            }
+         }
+
+         // the code scanners are not reentrant, source files are read and filtered on worker threads
+         // while the previous file is being highlighted
+         InputFileQueue readQueue(fileList, numThreads, filterSourceFiles, true);
+
+         int index = 0;
 
          for (auto &fn : Doxy_Globals::inputNameList) {
 
@@ -8315,13 +8398,28 @@ void Doxy_Work::generateSourceCode()
                   // source needs to be shown in the output
                   msg("Generating code for file %s\n", csPrintable(fd->docName()));
 
-                  fd->writeSource(Doxy_Globals::outputList, false, includeFiles);
+                  QString contents;
+
+                  if (readQueue.threadCount() > 0) {
+                     contents = readQueue.take(index);
+                  }
+
+                  ++index;
+                  fd->writeSource(Doxy_Globals::outputList, false, includeFiles, contents);
 
                } else if (! fd->isReference() && Doxy_Globals::parseSourcesNeeded) {
                   // parse the sources even if we do not show it
 
                   msg("Parsing code for file %s\n",  csPrintable(fd->docName()));
-                  fd->parseSource(false, includeFiles);
+
+                  QString contents;
+
+                  if (readQueue.threadCount() > 0) {
+                     contents = readQueue.take(index);
+                  }
+
+                  ++index;
+                  fd->parseSource(false, includeFiles, contents);
                }
 
                fd->finishParsing();
@@ -8577,6 +8675,7 @@ void Doxy_Work::flushCachedTemplateRelations()
    // have inheritance instances as direct or indirect sub classes.
 
    Doxy_Globals::lookupCache.clear();
+   clearArgumentMatchCache();
 
    // remove all cached typedef resolutions whose target is a
    // template class as this may now be a template instance
@@ -8627,6 +8726,7 @@ void Doxy_Work::flushUnresolvedRelations()
    // class C : public B::I {};
 
    Doxy_Globals::lookupCache.clear();
+   clearArgumentMatchCache();
 
    for (auto fn : Doxy_Globals::functionNameSDict) {
       // for each global function name
@@ -9327,8 +9427,45 @@ static ParserInterface *getParserForFile(const QString &fn)
    return Doxy_Globals::parserManager.getParser(extension);
 }
 
+// parse the translation units of the files following currentIndex on the clang worker threads,
+// nextIndex is the first file which has not been passed to the worker threads
+void Doxy_Work::prefetchTranslationUnits(const QStringList &fileList, int &nextIndex, int currentIndex)
+{
+   static const int numThreads = Config::getInt("parse-num-threads");
+   static const int maxAhead   = 2 * (numThreads == 0 ? QThread::idealThreadCount() : numThreads);
+
+   ClangParser *clangParser = ClangParser::instance();
+
+   if (! clangParser->canPrefetch()) {
+      return;
+   }
+
+   for ( ; nextIndex < fileList.count() && nextIndex <= currentIndex + maxAhead; ++nextIndex) {
+      const QString &fName = fileList[nextIndex];
+
+      bool ambig;
+      QSharedPointer<FileDef> fd = findFileDef(&Doxy_Globals::inputNameDict, fName, ambig);
+
+      if (! fd) {
+         continue;
+      }
+
+      auto srcLang = fd->getLanguage();
+
+      if (srcLang != SrcLangExt_Cpp && srcLang != SrcLangExt_ObjC) {
+         continue;
+      }
+
+      QStringList includedFiles;
+      fd->getAllIncludeFilesRecursively(includedFiles);
+
+      clangParser->prefetch(fName, includedFiles);
+   }
+}
+
 void Doxy_Work::parseFile(ParserInterface *parser, QSharedPointer<Entry> root,
-      QSharedPointer<FileDef> fd, QString fileName, enum ParserMode mode, QStringList &includedFiles)
+      QSharedPointer<FileDef> fd, QString fileName, enum ParserMode mode, QStringList &includedFiles,
+      InputFileQueue *readQueue, int queueIndex)
 {
    static const bool clangParsing        = Config::getBool("clang-parsing");
    static const bool enablePreprocessing = Config::getBool("enable-preprocessing");
@@ -9344,17 +9481,28 @@ void Doxy_Work::parseFile(ParserInterface *parser, QSharedPointer<Entry> root,
 
    QFileInfo fi(fileName);
    QString fileContents;
+   QString buffer;
 
    if (! clangParsing && enablePreprocessing && parser->needsPreprocessing(extension)) {
       msg("Processing %s\n", csPrintable(fileName));
 
-      fileContents = readInputFile(fileName);
+      if (readQueue != nullptr) {
+         fileContents = readQueue->take(queueIndex);
+      } else {
+         fileContents = readInputFile(fileName);
+      }
+
       fileContents = preprocessFile(fileName, fileContents);
 
    } else {
       // no preprocessing, if clang processing this branch is forced
       msg("Reading %s\n", csPrintable(fileName));
-      fileContents = readInputFile(fileName);
+
+      if (readQueue != nullptr) {
+         fileContents = readQueue->take(queueIndex);
+      } else {
+         fileContents = readInputFile(fileName);
+      }
    }
 
    if (! fileContents.endsWith("\n")) {
@@ -9363,8 +9511,12 @@ void Doxy_Work::parseFile(ParserInterface *parser, QSharedPointer<Entry> root,
    }
 
    // convert multi-line C++ comments to C style comments
-   QString buffer = convertCppComments(fileContents, fileName);
-   auto srcLang   = fd->getLanguage();
+   buffer = convertCppComments(fileContents, fileName);
+
+   // only the converted buffer is kept while the file is parsed
+   fileContents = QString();
+
+   auto srcLang = fd->getLanguage();
 
    if (clangParsing && (srcLang == SrcLangExt_Cpp || srcLang == SrcLangExt_ObjC)) {
       fd->getAllIncludeFilesRecursively(includedFiles);
@@ -9372,6 +9524,30 @@ void Doxy_Work::parseFile(ParserInterface *parser, QSharedPointer<Entry> root,
       // use clang for parsing
       parser->parseInput(fileName, buffer, root, mode, includedFiles, true);
 
+   } else if (EntryCache::instance()->isEnabled()) {
+      // use lex for parser, entries are reused from a previous run when the input has not changed
+      EntryCache *entryCache = EntryCache::instance();
+
+      QByteArray key = entryCache->key(fileName, buffer);
+      QSharedPointer<Entry> fileRoot = entryCache->load(key);
+
+      if (! fileRoot) {
+         QByteArray globalState = EntryCache::globalState();
+
+         fileRoot = QMakeShared<Entry>();
+         parser->parseInput(fileName, buffer, fileRoot, mode, includedFiles, false);
+
+         if (globalState == EntryCache::globalState()) {
+            entryCache->store(key, fileRoot);
+         }
+      }
+
+      root->m_srcLang = fileRoot->m_srcLang;
+
+      for (auto child : fileRoot->children()) {
+         root->addSubEntry(child);
+      }
+
    } else {
       // use lex for parser
       parser->parseInput(fileName, buffer, root, mode, includedFiles, false);
@@ -9392,10 +9568,22 @@ void Doxy_Work::parseFiles(QSharedPointer<Entry> root)
       QSet<QString> processedFiles;
       QSet<QString> filesToProcess;
 
+      QStringList sourceFiles;
+
       for (auto fName : Doxy_Globals::g_inputFiles) {
          filesToProcess.insert(fName);
+
+         bool ambig;
+         QSharedPointer<FileDef> fd = findFileDef(&Doxy_Globals::inputNameDict, fName, ambig);
+
+         if (fd && fd->isSource() && ! fd->isReference()) {
+            sourceFiles.append(fName);
+         }
       }
 
+      int sourceIndex = -1;
+      int nextIndex   = 0;
+
       // process source files and their include dependencies
       for (auto fName : Doxy_Globals::g_inputFiles) {
          bool ambig;
@@ -9406,6 +9594,9 @@ void Doxy_Work::parseFiles(QSharedPointer<Entry> root)
          if (fd->isSource() && ! fd->isReference()) {
             QStringList includedFiles;
 
+            ++sourceIndex;
+            prefetchTranslationUnits(sourceFiles, nextIndex, sourceIndex);
+
             auto srcLang = fd->getLanguage();
 
             ParserInterface *parser = getParserForFile(fName);
@@ -9438,12 +9629,26 @@ void Doxy_Work::parseFiles(QSharedPointer<Entry> root)
          }
       }
 
+      QStringList remainingFiles;
+
+      for (auto fName : Doxy_Globals::g_inputFiles) {
+         if (! processedFiles.contains(fName)) {
+            remainingFiles.append(fName);
+         }
+      }
+
+      int remainingIndex = -1;
+      nextIndex = 0;
+
       // process remaining files, treat as source files even if they are header files
       for (auto fName : Doxy_Globals::g_inputFiles) {
 
          if (! processedFiles.contains(fName)) {
             QStringList includedFiles;
 
+            ++remainingIndex;
+            prefetchTranslationUnits(remainingFiles, nextIndex, remainingIndex);
+
             bool ambig;
 
             QSharedPointer<FileDef> fd = findFileDef(&Doxy_Globals::inputNameDict, fName, ambig);
@@ -9462,8 +9667,21 @@ void Doxy_Work::parseFiles(QSharedPointer<Entry> root)
          }
       }
 
+      ClangParser::instance()->finishPrefetch();
+
    } else  {
       // use lex and not clang
+      static const int numThreads = Config::getInt("parse-num-threads");
+
+      // files are read and filtered by worker threads, the lex scanners are not
+      // reentrant so parsing is done on this thread in input order
+      InputFileQueue readQueue(Doxy_Globals::g_inputFiles, numThreads);
+
+      if (readQueue.threadCount() > 0) {
+         msg("Reading input files using %d parallel threads\n", readQueue.threadCount());
+      }
+
+      int index = 0;
 
       for (auto fName : Doxy_Globals::g_inputFiles) {
          QStringList includedFiles;
@@ -9474,7 +9692,9 @@ void Doxy_Work::parseFiles(QSharedPointer<Entry> root)
          assert(fd != nullptr);
 
          ParserInterface *parser = getParserForFile(fName);
-         parseFile(parser, root, fd, fName, ParserMode::SOURCE_FILE, includedFiles);
+         parseFile(parser, root, fd, fName, ParserMode::SOURCE_FILE, includedFiles, &readQueue, index);
+
+         ++index;
       }
    }
 }
@@ -9875,11 +10095,15 @@ void Doxy_Work::dumpGlossary()
    if (f.open(QIODevice::WriteOnly)) {
       QTextStream t(&f);
 
-      for (auto item : Doxy_Globals::glossary()) {
+      const SymbolTable &glossary = Doxy_Globals::glossary();
+
+      for (int id = 0; id < glossary.count(); ++id) {
          // list of phrases
 
-         QSharedPointer<Definition> def = sharedFrom(item);
-         dumpPhrase(t, def);
+         for (auto item : glossary.definitions(id)) {
+            QSharedPointer<Definition> def = sharedFrom(item);
+            dumpPhrase(t, def);
+         }
       }
    }
 }
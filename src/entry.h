@@ -466,6 +466,8 @@ class Entry : public EnableSharedFromThis
  private:
    Entry &operator=(const Entry &);
 
+   friend class EntryCache;
+
    QFlatMap<EntryKey, QString> m_entryMap;        // contains details about this entry
 
    QWeakPointer<Entry> m_parent;                  // parent node in the tree
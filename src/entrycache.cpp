@@ -0,0 +1,371 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+
+#include <entrycache.h>
+
+#include <config.h>
+#include <doxy_build_info.h>
+#include <doxy_globals.h>
+#include <entry.h>
+#include <message.h>
+
+// increase when the layout of the cache files changes
+static const qint32 entryCacheVersion = 1;
+
+static void writeArgumentList(QDataStream &stream, const ArgumentList &argList)
+{
+   stream << qint32(argList.count());
+
+   for (const auto &arg : argList) {
+      stream << arg.attrib << arg.type << arg.name << arg.array << arg.defval << arg.docs << arg.typeConstraint;
+   }
+
+   stream << argList.constSpecifier << argList.volatileSpecifier << argList.pureSpecifier
+          << qint32(argList.refSpecifier) << argList.trailingReturnType << argList.isDeleted;
+}
+
+static void readArgumentList(QDataStream &stream, ArgumentList &argList)
+{
+   qint32 count;
+   qint32 refSpecifier;
+
+   stream >> count;
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      Argument arg;
+      stream >> arg.attrib >> arg.type >> arg.name >> arg.array >> arg.defval >> arg.docs >> arg.typeConstraint;
+
+      argList.append(arg);
+   }
+
+   stream >> argList.constSpecifier >> argList.volatileSpecifier >> argList.pureSpecifier
+          >> refSpecifier >> argList.trailingReturnType >> argList.isDeleted;
+
+   argList.refSpecifier = static_cast<RefType>(refSpecifier);
+}
+
+EntryCache::EntryCache()
+   : m_hits(0), m_misses(0), m_stored(0)
+{
+   m_cacheDir = Config::getString("entry-cache-dir");
+
+   if (m_cacheDir.isEmpty()) {
+      return;
+   }
+
+   if (! QDir::isAbsolutePath(m_cacheDir)) {
+      m_cacheDir.prepend(Config::getString("output-dir") + "/");
+   }
+
+   if (! QDir().mkpath(m_cacheDir)) {
+      warn_uncond("Unable to create entry cache directory %s, cache disabled\n", csPrintable(m_cacheDir));
+      m_cacheDir = QString();
+
+      return;
+   }
+
+   // options which do not change the result of parsing a single file
+   static const QStringList ignore = { "entry-cache-dir", "input-source", "input-patterns", "input-recursive",
+         "exclude-files", "exclude-patterns", "exclude-symlinks", "parse-num-threads", "statistics-summary",
+         "statistics-file", "output-async-write" };
+
+   m_settingsHash = Config::getSettingsHash(ignore);
+   m_settingsHash.append(versionString.toUtf8());
+}
+
+EntryCache *EntryCache::instance()
+{
+   static EntryCache retval;
+   return &retval;
+}
+
+QByteArray EntryCache::key(const QString &fileName, const QString &buffer) const
+{
+   QCryptographicHash hash(QCryptographicHash::Md5);
+
+   hash.addData(m_settingsHash);
+   hash.addData(fileName.toUtf8());
+
+   // the string is stored as UTF-8, hash it without converting a copy
+   hash.addData(buffer.constData(), buffer.size_storage());
+
+   return hash.result().toHex();
+}
+
+QString EntryCache::cacheFileName(const QByteArray &key) const
+{
+   return m_cacheDir + "/" + QString::fromLatin1(key) + ".entry";
+}
+
+QByteArray EntryCache::globalState()
+{
+   QByteArray retval;
+
+   retval += QByteArray::number(Doxy_Globals::sectionDict.count()) + ":";
+   retval += QByteArray::number(Doxy_Globals::formulaList.count()) + ":";
+   retval += QByteArray::number(Doxy_Globals::xrefLists.count()) + ":";
+   retval += QByteArray::number(Doxy_Globals::memGrpInfoDict.count()) + ":";
+   retval += QByteArray::number(Doxy_Globals::namespaceAliasDict.count());
+
+   return retval;
+}
+
+QSharedPointer<Entry> EntryCache::load(const QByteArray &key)
+{
+   QSharedPointer<Entry> retval;
+   QFile file(cacheFileName(key));
+
+   if (file.open(QIODevice::ReadOnly)) {
+      QDataStream stream(&file);
+
+      qint32 version;
+      stream >> version;
+
+      if (version == entryCacheVersion) {
+         retval = readEntry(stream);
+
+         if (stream.status() != QDataStream::Ok) {
+            // truncated or damaged cache file, parse the file again
+            retval = QSharedPointer<Entry>();
+         }
+      }
+   }
+
+   if (retval) {
+      ++m_hits;
+   } else {
+      ++m_misses;
+   }
+
+   return retval;
+}
+
+bool EntryCache::store(const QByteArray &key, QSharedPointer<Entry> root)
+{
+   if (! isCacheable(root)) {
+      return false;
+   }
+
+   QString fileName = cacheFileName(key);
+   QFile file(fileName + ".tmp");
+
+   if (! file.open(QIODevice::WriteOnly)) {
+      return false;
+   }
+
+   QDataStream stream(&file);
+   stream << entryCacheVersion;
+
+   writeEntry(stream, root);
+   file.close();
+
+   if (stream.status() != QDataStream::Ok) {
+      file.remove();
+      return false;
+   }
+
+   // rename so a partially written file is never read
+   QFile::remove(fileName);
+
+   if (! file.rename(fileName)) {
+      file.remove();
+      return false;
+   }
+
+   ++m_stored;
+
+   return true;
+}
+
+bool EntryCache::isCacheable(QSharedPointer<Entry> root)
+{
+   // anonymous scopes are numbered in the order they are found in all files
+   if (root->m_entryName.contains('@')) {
+      return false;
+   }
+
+   // anchors, special list items and member groups are registered globally
+   if (! root->m_anchors.isEmpty() || ! root->m_specialLists.isEmpty() || root->mGrpId != -1) {
+      return false;
+   }
+
+   // formula ids and citations refer to global lists
+   for (auto key : { EntryKey::Brief_Docs, EntryKey::Main_Docs, EntryKey::Inbody_Docs }) {
+      QString docs = root->getData(key);
+
+      if (docs.contains("\\form#") || docs.contains("\\cite") || docs.contains("@cite")) {
+         return false;
+      }
+   }
+
+   for (auto child : root->children()) {
+      if (! isCacheable(child)) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+void EntryCache::writeEntry(QDataStream &stream, QSharedPointer<Entry> root)
+{
+   stream << root->m_tagInfo.tag_Name << root->m_tagInfo.tag_FileName << root->m_tagInfo.tag_Anchor;
+
+   writeArgumentList(stream, root->argList);
+   writeArgumentList(stream, root->typeConstr);
+
+   stream << qint32(root->relatesType) << qint32(root->virt) << qint32(root->protection) << qint32(root->mtype)
+          << qint32(root->groupDocType) << qint32(root->m_srcLang) << root->m_traits.toQByteArray();
+
+   stream << qint32(root->section) << qint32(root->initLines) << qint32(root->docLine) << qint32(root->briefLine)
+          << qint32(root->inbodyLine) << qint32(root->bodyLine) << qint32(root->endBodyLine)
+          << qint32(root->mGrpId) << qint32(root->startLine) << qint32(root->startColumn);
+
+   stream << root->stat << root->explicitExternal << root->proto << root->subGrouping << root->callGraph
+          << root->callerGraph << root->hidden << root->artificial;
+
+   stream << root->m_entryName;
+
+   stream << qint32(root->m_templateArgLists.count());
+
+   for (const auto &argList : root->m_templateArgLists) {
+      writeArgumentList(stream, argList);
+   }
+
+   stream << qint32(root->extends.count());
+
+   for (const auto &item : root->extends) {
+      stream << item.name << qint32(item.prot) << qint32(item.virt);
+   }
+
+   stream << qint32(root->m_groups.count());
+
+   for (const auto &item : root->m_groups) {
+      stream << item.groupname << qint32(item.pri);
+   }
+
+   stream << qint32(root->m_entryMap.count());
+
+   for (auto iter = root->m_entryMap.begin(); iter != root->m_entryMap.end(); ++iter) {
+      stream << qint32(iter.key()) << iter.value();
+   }
+
+   stream << qint32(root->m_sublist.count());
+
+   for (auto child : root->m_sublist) {
+      writeEntry(stream, child);
+   }
+}
+
+QSharedPointer<Entry> EntryCache::readEntry(QDataStream &stream)
+{
+   QSharedPointer<Entry> root = QMakeShared<Entry>();
+
+   qint32 relatesType;
+   qint32 virt;
+   qint32 protection;
+   qint32 mtype;
+   qint32 groupDocType;
+   qint32 srcLang;
+   qint32 count;
+
+   QByteArray traits;
+
+   stream >> root->m_tagInfo.tag_Name >> root->m_tagInfo.tag_FileName >> root->m_tagInfo.tag_Anchor;
+
+   readArgumentList(stream, root->argList);
+   readArgumentList(stream, root->typeConstr);
+
+   stream >> relatesType >> virt >> protection >> mtype >> groupDocType >> srcLang >> traits;
+
+   root->relatesType  = static_cast<RelatesType>(relatesType);
+   root->virt         = static_cast<Specifier>(virt);
+   root->protection   = static_cast<Protection>(protection);
+   root->mtype        = static_cast<MethodTypes>(mtype);
+   root->groupDocType = static_cast<Entry::GroupDocType>(groupDocType);
+   root->m_srcLang    = static_cast<SrcLangExt>(srcLang);
+   root->m_traits     = Entry::Traits::fromQByteArray(traits);
+
+   stream >> root->section >> root->initLines >> root->docLine >> root->briefLine
+          >> root->inbodyLine >> root->bodyLine >> root->endBodyLine
+          >> root->mGrpId >> root->startLine >> root->startColumn;
+
+   stream >> root->stat >> root->explicitExternal >> root->proto >> root->subGrouping >> root->callGraph
+          >> root->callerGraph >> root->hidden >> root->artificial;
+
+   stream >> root->m_entryName;
+
+   stream >> count;
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      ArgumentList argList;
+      readArgumentList(stream, argList);
+
+      root->m_templateArgLists.append(argList);
+   }
+
+   stream >> count;
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      QString name;
+      qint32 prot;
+
+      stream >> name >> prot >> virt;
+      root->extends.append(BaseInfo(name, static_cast<Protection>(prot), static_cast<Specifier>(virt)));
+   }
+
+   stream >> count;
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      QString name;
+      qint32 pri;
+
+      stream >> name >> pri;
+      root->m_groups.append(Grouping(name, static_cast<Grouping::GroupPri_t>(pri)));
+   }
+
+   stream >> count;
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      qint32 key;
+      QString value;
+
+      stream >> key >> value;
+      root->m_entryMap.insert(static_cast<EntryKey>(key), value);
+   }
+
+   stream >> count;
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      root->addSubEntry(readEntry(stream));
+   }
+
+   return root;
+}
+
+void EntryCache::printStatistics() const
+{
+   if (isEnabled()) {
+      msg("Entry cache: %d files loaded, %d files parsed, %d files stored\n", m_hits, m_misses, m_stored);
+   }
+}
@@ -0,0 +1,83 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#ifndef ENTRYCACHE_H
+#define ENTRYCACHE_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QSharedPointer>
+#include <QString>
+
+class Entry;
+
+/** Persistent cache of the Entry trees produced by the lex based parsers.
+ *
+ *  The key is a hash of the preprocessed file contents, the file name and the
+ *  project settings. Preprocessing is always done since the macro definitions
+ *  are needed by files parsed later. Only the scanner and the comment parser
+ *  are skipped when the key is found in the cache directory.
+ *
+ *  A tree is only stored when parsing the file did not change any global
+ *  state, such as sections, formulas, cross reference lists or member groups,
+ *  since these changes can not be replayed when the tree is loaded.
+ */
+class EntryCache
+{
+ public:
+   static EntryCache *instance();
+
+   bool isEnabled() const {
+      return ! m_cacheDir.isEmpty();
+   }
+
+   /** Returns the key for the given file and the contents passed to the parser */
+   QByteArray key(const QString &fileName, const QString &buffer) const;
+
+   /** Returns a root entry whose children are the cached entries for \a key or
+    *  a null pointer if the key is not in the cache
+    */
+   QSharedPointer<Entry> load(const QByteArray &key);
+
+   /** Saves the children of \a root, returns false if the tree can not be cached */
+   bool store(const QByteArray &key, QSharedPointer<Entry> root);
+
+   /** Returns a value which changes when the parser modifies global state */
+   static QByteArray globalState();
+
+   void printStatistics() const;
+
+ private:
+   EntryCache();
+
+   QString cacheFileName(const QByteArray &key) const;
+   static bool isCacheable(QSharedPointer<Entry> root);
+
+   static void writeEntry(QDataStream &stream, QSharedPointer<Entry> root);
+   static QSharedPointer<Entry> readEntry(QDataStream &stream);
+
+   QString    m_cacheDir;
+   QByteArray m_settingsHash;
+
+   int m_hits;
+   int m_misses;
+   int m_stored;
+};
+
+#endif
@@ -0,0 +1,222 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QMultiMap>
+#include <QStandardPaths>
+#include <QStringList>
+
+#include <filecache.h>
+
+#include <config.h>
+#include <message.h>
+#include <portable.h>
+
+FileContentCache::FileContentCache()
+   : m_hits(0), m_misses(0), m_evicted(0)
+{
+   // size in MB
+   int cacheSize = qBound(0, Config::getInt("file-cache-size"), 2047);
+   m_cache.setMaxCost(cacheSize * 1024 * 1024);
+
+   m_encoding     = Config::getString("input-encoding");
+   m_maxSpillSize = qint64(Config::getInt("file-cache-dir-size")) * 1024 * 1024;
+
+   m_spillDir = Config::getString("file-cache-dir");
+
+   if (! m_spillDir.isEmpty()) {
+
+      if (! QDir::isAbsolutePath(m_spillDir)) {
+         m_spillDir.prepend(Config::getString("output-dir") + "/");
+      }
+
+      if (! QDir().mkpath(m_spillDir)) {
+         warn_uncond("Unable to create file cache directory %s\n", csPrintable(m_spillDir));
+         m_spillDir = QString();
+      }
+   }
+}
+
+FileContentCache *FileContentCache::instance()
+{
+   static FileContentCache retval;
+   return &retval;
+}
+
+QString FileContentCache::key(const QFileInfo &fi, const QString &filter) const
+{
+   QString retval = fi.absoluteFilePath() + "\n" + QString::number(fi.lastModified().toMSecsSinceEpoch()) + "\n" +
+                  QString::number(fi.size()) + "\n" + m_encoding + "\n" + filter;
+
+   if (! filter.isEmpty()) {
+      retval += "\n" + filterStamp(filter);
+   }
+
+   return retval;
+}
+
+// modification times of the program and the scripts named in a filter command, a changed filter
+// produces different output for the same input file
+QString FileContentCache::filterStamp(const QString &filter) const
+{
+   QMutexLocker locker(&m_mutex);
+
+   auto iter = m_filterStamps.constFind(filter);
+
+   if (iter != m_filterStamps.constEnd()) {
+      return iter.value();
+   }
+
+   QString retval;
+   const QStringList parts = filter.split(' ');
+   bool isProgram = true;
+
+   for (QString name : parts) {
+      name.remove('"');
+
+      if (name.isEmpty()) {
+         continue;
+      }
+
+      QFileInfo fi(name);
+
+      if (isProgram && ! fi.exists()) {
+         // program found in the path
+         fi = QFileInfo(QStandardPaths::findExecutable(name));
+      }
+
+      if (fi.isFile()) {
+         retval += QString::number(fi.lastModified().toMSecsSinceEpoch()) + ":";
+      }
+
+      isProgram = false;
+   }
+
+   m_filterStamps.insert(filter, retval);
+
+   return retval;
+}
+
+QString FileContentCache::spillFileName(const QString &key) const
+{
+   QByteArray data = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex();
+   return m_spillDir + "/" + QString::fromLatin1(data) + ".txt";
+}
+
+bool FileContentCache::find(const QString &key, QString &contents)
+{
+   QMutexLocker locker(&m_mutex);
+
+   QString *item = m_cache.object(key);
+
+   if (item != nullptr) {
+      contents = *item;
+      ++m_hits;
+
+      return true;
+   }
+
+   if (! m_spillDir.isEmpty()) {
+      QFile f(spillFileName(key));
+
+      if (f.open(QIODevice::ReadOnly)) {
+         contents = QString::fromUtf8(f.readAll());
+         ++m_hits;
+
+         // modification time is used as the time of last use when evicting
+         f.close();
+         portable_touchFile(f.fileName());
+
+         m_cache.insert(key, new QString(contents), contents.size_storage());
+
+         return true;
+      }
+   }
+
+   ++m_misses;
+
+   return false;
+}
+
+void FileContentCache::insert(const QString &key, const QString &contents, bool filtered)
+{
+   QMutexLocker locker(&m_mutex);
+
+   m_cache.insert(key, new QString(contents), contents.size_storage());
+
+   if (filtered && ! m_spillDir.isEmpty()) {
+      // only the output of a filter is saved, reading an unfiltered file again is just as fast
+      QString fileName = spillFileName(key);
+      QFile f(fileName + ".tmp");
+
+      if (f.open(QIODevice::WriteOnly)) {
+         QByteArray data = contents.toUtf8();
+
+         if (f.write(data) == data.size()) {
+            f.close();
+
+            QFile::remove(fileName);
+            f.rename(fileName);
+
+         } else {
+            f.remove();
+
+         }
+      }
+   }
+}
+
+void FileContentCache::evict()
+{
+   if (m_spillDir.isEmpty() || m_maxSpillSize <= 0) {
+      return;
+   }
+
+   QMutexLocker locker(&m_mutex);
+
+   QMultiMap<QDateTime, QFileInfo> byLastUse;
+   qint64 totalSize = 0;
+
+   const QFileInfoList fileList = QDir(m_spillDir).entryInfoList(QStringList("*.txt"), QDir::Files);
+
+   for (const auto &fi : fileList) {
+      byLastUse.insert(fi.lastModified(), fi);
+      totalSize += fi.size();
+   }
+
+   for (auto iter = byLastUse.begin(); iter != byLastUse.end() && totalSize > m_maxSpillSize; ++iter) {
+      if (QFile::remove(iter.value().absoluteFilePath())) {
+         totalSize -= iter.value().size();
+         ++m_evicted;
+      }
+   }
+}
+
+void FileContentCache::printStatistics() const
+{
+   QMutexLocker locker(&m_mutex);
+
+   if (m_hits + m_misses > 0) {
+      msg("File cache used %d/%d KB, %d hits, %d misses, %d files removed\n", m_cache.totalCost() / 1024,
+                  m_cache.maxCost() / 1024, m_hits, m_misses, m_evicted);
+   }
+}
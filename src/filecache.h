@@ -0,0 +1,81 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#ifndef FILECACHE_H
+#define FILECACHE_H
+
+#include <QCache>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+/** Cache of the contents of input files after filtering and transcoding.
+ *
+ *  The key is the path, modification time and size of the file, the input encoding,
+ *  the filter command and the modification time of the files named in the command.
+ *  Files are kept in memory up to the size given by file-cache-size. When
+ *  file-cache-dir is set the output of a filter is also saved to disk and reused by
+ *  later runs, a filter is then only started when the file changes. The least
+ *  recently used files are removed when the directory exceeds file-cache-dir-size.
+ *
+ *  The cache is used by the threads reading the input files so all methods
+ *  are thread safe.
+ */
+class FileContentCache
+{
+ public:
+   static FileContentCache *instance();
+
+   /** Returns the key for \a fi when it is read using the given filter */
+   QString key(const QFileInfo &fi, const QString &filter) const;
+
+   /** Returns true and sets \a contents if \a key is found in memory or on disk */
+   bool find(const QString &key, QString &contents);
+
+   /** Adds the contents of a file, \a filtered indicates the file was passed through a filter */
+   void insert(const QString &key, const QString &contents, bool filtered);
+
+   /** Removes the least recently used files until file-cache-dir is smaller than file-cache-dir-size */
+   void evict();
+
+   void printStatistics() const;
+
+ private:
+   FileContentCache();
+
+   QString spillFileName(const QString &key) const;
+   QString filterStamp(const QString &filter) const;
+
+   QCache<QString, QString> m_cache;
+   QString m_spillDir;
+   QString m_encoding;
+
+   mutable QHash<QString, QString> m_filterStamps;
+
+   qint64 m_maxSpillSize;
+
+   int m_hits;
+   int m_misses;
+   int m_evicted;
+
+   mutable QMutex m_mutex;
+};
+
+#endif
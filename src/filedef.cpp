@@ -315,8 +315,8 @@ void FileDef::writeBriefDescription(OutputList &ol)
 
    if (hasBriefDescription()) {
 
-      DocRoot *rootNode = validatingParseDoc(briefFile(), briefLine(), self, QSharedPointer<MemberDef>(),
-                                             briefDescription(), true, false, "", true, false);
+      QSharedPointer<DocRoot> rootNode = cachedParseDoc(briefFile(), briefLine(), self, QSharedPointer<MemberDef>(),
+                  briefDescription(), true, false, "", true, false);
 
       if (rootNode && !rootNode->isEmpty()) {
          ol.startParagraph();
@@ -326,7 +326,7 @@ void FileDef::writeBriefDescription(OutputList &ol)
          ol.writeString(" - ");
          ol.popGeneratorState();
 
-         ol.writeDoc(rootNode, self, QSharedPointer<MemberDef>());
+         ol.writeDoc(rootNode.data(), self, QSharedPointer<MemberDef>());
 
          ol.pushGeneratorState();
          ol.disable(OutputGenerator::RTF);
@@ -344,7 +344,6 @@ void FileDef::writeBriefDescription(OutputList &ol)
          ol.endParagraph();
       }
 
-      delete rootNode;
    }
 
    ol.writeSynopsis();
@@ -851,7 +850,7 @@ void FileDef::writeQuickMemberLinks(OutputList &ol, QSharedPointer<MemberDef> cu
 }
 
 // write source listing of this file to the output
-void FileDef::writeSource(OutputList &ol, bool sameTu, QStringList &includedFiles)
+void FileDef::writeSource(OutputList &ol, bool sameTu, QStringList &includedFiles, const QString &contents)
 {
    QSharedPointer<FileDef> self = sharedFrom(this);
 
@@ -964,7 +963,7 @@ void FileDef::writeSource(OutputList &ol, bool sameTu, QStringList &includedFile
          pIntf->parseCode(devNullIntf, 0, fileToString(getFilePath(), true, true), getLanguage(), false, 0, self);
       }
 
-      pIntf->parseCode(ol, 0, fileToString(getFilePath(), filterSourceFiles, true),
+      pIntf->parseCode(ol, 0, contents.isEmpty() ? fileToString(getFilePath(), filterSourceFiles, true) : contents,
                        srcLang, false, 0, self, -1, -1, false,
                        QSharedPointer<MemberDef>(), true, QSharedPointer<Definition>(), ! needs2PassParsing);
 
@@ -976,7 +975,7 @@ void FileDef::writeSource(OutputList &ol, bool sameTu, QStringList &includedFile
    ol.enableAll();
 }
 
-void FileDef::parseSource(bool sameTu, QStringList &includedFiles)
+void FileDef::parseSource(bool sameTu, QStringList &includedFiles, const QString &contents)
 {
    QSharedPointer<FileDef> self  = sharedFrom(this);
    static bool filterSourceFiles = Config::getBool("filter-source-files");
@@ -1001,7 +1000,8 @@ void FileDef::parseSource(bool sameTu, QStringList &includedFiles)
 
       ParserInterface *pIntf = Doxy_Globals::parserManager.getParser(getDefFileExtension());
       pIntf->resetCodeParserState();
-      pIntf->parseCode(devNullIntf, 0, fileToString(getFilePath(), filterSourceFiles, true), srcLang, false, 0, self);
+      pIntf->parseCode(devNullIntf, 0, contents.isEmpty() ? fileToString(getFilePath(), filterSourceFiles, true) : contents,
+                  srcLang, false, 0, self);
    }
 }
 
@@ -216,8 +216,9 @@ class FileDef : public Definition
    void writeTagFile(QTextStream &t);
 
    void startParsing();
-   void writeSource(OutputList &ol, bool sameTu, QStringList &filesInSameTu);
-   void parseSource(bool sameTu, QStringList &filesInSameTu);
+   // contents is the source as read by fileToString(), the file is read when empty
+   void writeSource(OutputList &ol, bool sameTu, QStringList &filesInSameTu, const QString &contents = QString());
+   void parseSource(bool sameTu, QStringList &filesInSameTu, const QString &contents = QString());
    void finishParsing();
 
    friend void generatedFileNames();
@@ -350,7 +350,7 @@ static void generateBriefDoc(QTextStream &t, QSharedPointer<Definition> def)
    QString brief = def->briefDescription(true);
 
    if (! brief.isEmpty()) {
-      DocNode *root = validatingParseDoc(def->briefFile(), def->briefLine(),
+      QSharedPointer<DocRoot> root = cachedParseDoc(def->briefFile(), def->briefLine(),
                   def, QSharedPointer<MemberDef>(), brief, false, false, "", true, true);
 
       QString relPath = relativePathToRoot(def->getOutputFileBase());
@@ -360,7 +360,6 @@ static void generateBriefDoc(QTextStream &t, QSharedPointer<Definition> def)
       root->accept(visitor);
 
       delete visitor;
-      delete root;
    }
 }
 
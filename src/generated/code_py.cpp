@@ -2022,16 +2022,12 @@ static bool findMemberLink(CodeOutputInterface &ol, QSharedPointer<Definition> d
 static void findMemberLink(CodeOutputInterface &ol, const QString &phrase)
 {
    if (s_currentDefinition) {
-      auto iter = Doxy_Globals::glossary().find(phrase);
-
-      while (iter != Doxy_Globals::glossary().end() && iter.key() == phrase) {
-         QSharedPointer<Definition> def = sharedFrom(iter.value());
+      for (auto item : Doxy_Globals::glossary().definitions(phrase)) {
+         QSharedPointer<Definition> def = sharedFrom(item);
 
          if (findMemberLink(ol, def, phrase)) {
             return;
          }
-
-         ++iter;
       }
    }
 
@@ -3917,5 +3917,8 @@ QString convertCppComments(const QString &inBuf, const QString &fileName)
    s_commentStack.clear();
    s_nestingCount = 0;
 
-   return s_outputString;
+   // release the input and move the output so the caller owns the only reference
+   s_inputString = QString();
+
+   return std::move(s_outputString);
 }
@@ -25923,6 +25923,9 @@ static void parseMain(const QString &fileName, const QString &fileBuf, QStringLi
       parseCompounds(rt);
       s_inputFile.close();
 
+      // release the file contents, the scanner keeps no reference to it
+      s_inputString = QString();
+
       anonNSCount++;
    }
 }
@@ -2644,6 +2644,7 @@ char *preYYtext;
 #include <QFile>
 #include <QFileInfo>
 #include <QHash>
+#include <QPair>
 #include <QRegularExpression>
 #include <QStringList>
 #include <QStack>
@@ -2659,6 +2660,7 @@ char *preYYtext;
 #include <doxy_globals.h>
 #include <default_args.h>
 #include <entry.h>
+#include <includeresolver.h>
 #include <message.h>
 #include <membername.h>
 #include <util.h>
@@ -2696,11 +2698,25 @@ struct FileState {
  */
 class DefineManager
 {
+   class DefinesPerFile;
+
+   // defines of a file and all files it includes, shared by every context which includes the file
+   struct DefineSnapshot {
+      DefineSnapshot() : id(0), changeCount(0) {}
+
+      DefineDict defines;
+      int id;
+
+      // files the defines were collected from and their version at that time
+      QVector<QPair<const DefinesPerFile *, int>> files;
+      int changeCount;
+   };
+
    // local class used to hold the defines for a single file
    class DefinesPerFile
    {
     public:
-      DefinesPerFile() {
+      DefinesPerFile() : m_version(0) {
       }
 
       virtual ~DefinesPerFile() {
@@ -2719,20 +2735,40 @@ class DefineManager
          }
 
          m_defines.insert(def->m_name, def);
+         ++m_version;
       }
 
       /** Adds an include file for this file
        *  @param fileName The name of the include file
        */
       void addInclude(const QString &fileName) {
-         m_includedFiles.insert(fileName);
+         if (! m_includedFiles.contains(fileName)) {
+            m_includedFiles.insert(fileName);
+            ++m_version;
+         }
       }
 
       void collectDefines(DefineDict &dict, QSet<QString> &includeStack);
 
+      /** Returns a value which changes when a define or an include file is added */
+      int version() const {
+         return m_version;
+      }
+
+      QSharedPointer<DefineSnapshot> snapshot() const {
+         return m_snapshot;
+      }
+
+      void setSnapshot(QSharedPointer<DefineSnapshot> snapshot) {
+         m_snapshot = snapshot;
+      }
+
     private:
       DefineDict m_defines;
       QSet<QString> m_includedFiles;
+      int m_version;
+
+      QSharedPointer<DefineSnapshot> m_snapshot;
    };
 
  public:
@@ -2757,6 +2793,8 @@ class DefineManager
     */
    void startContext(const QString &fileName) {
       m_contextDefines.clear();
+      m_contextSnapshots.clear();
+
       if (fileName.isEmpty()) {
          return;
       }
@@ -2775,6 +2813,7 @@ class DefineManager
     */
    void endContext() {
       m_contextDefines.clear();
+      m_contextSnapshots.clear();
    }
 
    /** Add an included file to the current context.
@@ -2796,9 +2835,7 @@ class DefineManager
 
       } else {
          // existing file
-
-         QSet<QString> includeStack;
-         dpf->collectDefines(m_contextDefines, includeStack);
+         addSnapshotToContext(fileSnapshot(dpf));
       }
    }
 
@@ -2819,6 +2856,7 @@ class DefineManager
       }
 
       m_contextDefines.insert(def->m_name, def);
+      ++m_contextVersion;
 
       //
       QSharedPointer<DefinesPerFile> dpf = m_fileMap.value(fileName);
@@ -2829,6 +2867,7 @@ class DefineManager
       }
 
       dpf->addDefine(def);
+      ++m_changeCount;
    }
 
    /** Add an include relation to the manager object.
@@ -2846,7 +2885,18 @@ class DefineManager
          dpf = QMakeShared<DefinesPerFile>();
          m_fileMap.insert(fromFileName, dpf);
       }
+
+      int version = dpf->version();
       dpf->addInclude(toFileName);
+
+      if (dpf->version() != version) {
+         ++m_changeCount;
+      }
+
+      if (! m_fileMap.contains(toFileName)) {
+         // every included file is known, so the files of a snapshot are complete
+         m_fileMap.insert(toFileName, QMakeShared<DefinesPerFile>());
+      }
    }
 
    /** Returns a Define object given its name or 0 if the Define does not exist.
@@ -2866,9 +2916,100 @@ class DefineManager
       return m_contextDefines;
    }
 
+   void printStatistics() const {
+      if (m_snapshotsBuilt + m_snapshotsReused > 0) {
+         msg("Preprocessor: %d include snapshots built, %d reused, %d merges skipped\n",
+               m_snapshotsBuilt, m_snapshotsReused, m_mergesSkipped);
+      }
+   }
+
  private:
    static DefineManager *theInstance;
 
+   /** Returns the defines of a file and all files it includes. The snapshot is only collected
+    *  again when a define or an include was added to one of these files.
+    */
+   QSharedPointer<DefineSnapshot> fileSnapshot(QSharedPointer<DefinesPerFile> dpf) {
+      QSharedPointer<DefineSnapshot> retval = dpf->snapshot();
+
+      if (retval != nullptr) {
+         bool valid = (retval->changeCount == m_changeCount);
+
+         if (! valid) {
+            valid = true;
+
+            for (const auto &item : retval->files) {
+               if (item.first->version() != item.second) {
+                  valid = false;
+                  break;
+               }
+            }
+         }
+
+         if (valid) {
+            retval->changeCount = m_changeCount;
+            ++m_snapshotsReused;
+
+            return retval;
+         }
+      }
+
+      retval = QMakeShared<DefineSnapshot>();
+      retval->id = ++m_snapshotsBuilt;
+      retval->changeCount = m_changeCount;
+
+      QSet<QString> includeStack;
+      dpf->collectDefines(retval->defines, includeStack);
+
+      retval->files.append(qMakePair(dpf.data(), dpf->version()));
+
+      for (const auto &item : includeStack) {
+         QSharedPointer<DefinesPerFile> incDpf = m_fileMap.value(item);
+         retval->files.append(qMakePair(incDpf.data(), incDpf->version()));
+      }
+
+      dpf->setSnapshot(retval);
+
+      return retval;
+   }
+
+   /** Adds the defines of a snapshot to the current context, a redefine replaces the define
+    *  in the context. Merging is skipped when the snapshot was already merged and the context
+    *  has not changed since.
+    */
+   void addSnapshotToContext(QSharedPointer<DefineSnapshot> snapshot) {
+      if (m_contextDefines.isEmpty()) {
+         // shared until a define is added to the context
+         m_contextDefines = snapshot->defines;
+         ++m_contextVersion;
+
+      } else {
+         auto iter = m_contextSnapshots.constFind(snapshot->id);
+
+         if (iter != m_contextSnapshots.constEnd() && iter.value() == m_contextVersion) {
+            ++m_mergesSkipped;
+            return;
+         }
+
+         bool changed = false;
+
+         for (auto def = snapshot->defines.constBegin(); def != snapshot->defines.constEnd(); ++def) {
+            auto item = m_contextDefines.constFind(def.key());
+
+            if (item == m_contextDefines.constEnd() || item.value() != def.value()) {
+               m_contextDefines.insert(def.key(), def.value());
+               changed = true;
+            }
+         }
+
+         if (changed) {
+            ++m_contextVersion;
+         }
+      }
+
+      m_contextSnapshots.insert(snapshot->id, m_contextVersion);
+   }
+
    /** Helper function to collect all define for a given file */
    void collectDefinesForFile(const QString &fileName, QSharedPointer<DefineDict> dict) {
       if (fileName.isEmpty()) {
@@ -2892,7 +3033,8 @@ class DefineManager
       return m_fileMap.value(fileName);
    }
 
-   DefineManager() {
+   DefineManager()
+      : m_changeCount(0), m_contextVersion(0), m_snapshotsBuilt(0), m_snapshotsReused(0), m_mergesSkipped(0) {
    }
 
    virtual ~DefineManager() {
@@ -2900,6 +3042,18 @@ class DefineManager
 
    QHash<QString, QSharedPointer<DefinesPerFile>> m_fileMap;
    DefineDict m_contextDefines;
+
+   // incremented when a define or an include is added to any file
+   int m_changeCount;
+
+   // snapshot id mapped to the context version when it was merged, the version is
+   // incremented when the defines of the context change
+   QHash<int, int> m_contextSnapshots;
+   int m_contextVersion;
+
+   int m_snapshotsBuilt;
+   int m_snapshotsReused;
+   int m_mergesSkipped;
 };
 
 /** Singleton instance */
@@ -3060,15 +3214,15 @@ static QSharedPointer<FileState> checkAndOpenFile(const QString &fileName, bool
    alreadyIncluded = false;
    QSharedPointer<FileState> fs;
 
-   QFileInfo fi(fileName);
+   IncludeResolver *resolver = IncludeResolver::instance();
 
-   if (fi.exists() && fi.isFile()) {
-      static const QStringList exclPatterns = Config::getList("exclude-patterns");
+   if (resolver->isFile(fileName)) {
 
-      if (patternMatch(fi, exclPatterns)) {
+      if (resolver->isExcluded(fileName)) {
          return QSharedPointer<FileState>();
       }
 
+      QFileInfo fi(fileName);
       QString absName = fi.absoluteFilePath();
 
       // global guard
@@ -3138,9 +3292,10 @@ static QSharedPointer<FileState> findFile(const QString &fileName, bool localInc
    }
 
    if (localInclude && ! s_yyFileName.isEmpty()) {
-      QFileInfo fi(s_yyFileName);
 
-      if (fi.exists()) {
+      if (IncludeResolver::instance()->isFile(s_yyFileName)) {
+         QFileInfo fi(s_yyFileName);
+
          QString absName = fi.absolutePath() + "/" + fileName;
          QSharedPointer<FileState> fs = checkAndOpenFile(absName, alreadyIncluded);
 
@@ -4291,36 +4446,26 @@ static void readIncludeFile(const QString &inc)
       // absIncFileName avoids difficulties for incFileName starting with "../" (bug 641336)
       QString absIncFileName = incFileName;
       {
-         QFileInfo fi(s_yyFileName);
+         IncludeResolver *resolver = IncludeResolver::instance();
 
-         if (fi.exists()) {
-            QString absName = fi.absolutePath() + "/" + incFileName;
+         if (resolver->isFile(s_yyFileName)) {
+            QString absName = resolver->find(QFileInfo(s_yyFileName).absolutePath(), incFileName);
 
-            QFileInfo fi2(absName);
-            if (fi2.exists()) {
-               absIncFileName = fi2.absoluteFilePath();
+            if (! absName.isEmpty()) {
+               absIncFileName = absName;
 
             } else if (searchIncludes) {
-               const QStringList includePath = Config::getList("include-path");
+               static const QStringList includePath = Config::getList("include-path");
 
                for (auto s : includePath) {
+                  absName = resolver->find(s, incFileName);
 
-                  QFileInfo fi(s);
-
-                  if (fi.exists() && fi.isDir()) {
-                     QString absName = fi.absoluteFilePath() + "/" + incFileName;
-
-                     QFileInfo fi2(absName);
-                     if (fi2.exists()) {
-                        absIncFileName = fi2.absoluteFilePath();
-                        break;
-                     }
-
+                  if (! absName.isEmpty()) {
+                     absIncFileName = absName;
+                     break;
                   }
-
                }
             }
-
          }
       }
 
@@ -8251,7 +8396,15 @@ QString preprocessFile(const QString &fileName, const QString &input)
    DefineManager::instance().endContext();
    printlex(preYY_flex_debug, false, __FILE__, fileName);
 
-   return s_outputString;
+   // release the input and move the output so the caller owns the only reference
+   s_inputString = QString();
+
+   return std::move(s_outputString);
+}
+
+void printPreprocessorStatistics()
+{
+   DefineManager::instance().printStatistics();
 }
 
 void preFreeScanner()
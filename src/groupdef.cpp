@@ -738,8 +738,8 @@ void GroupDef::writeBriefDescription(OutputList &ol)
    QSharedPointer<GroupDef> self = sharedFrom(this);
 
    if (hasBriefDescription()) {
-      DocRoot *rootNode = validatingParseDoc(briefFile(), briefLine(), self, QSharedPointer<MemberDef>(),
-                                             briefDescription(), true, false, "", true, false);
+      QSharedPointer<DocRoot> rootNode = cachedParseDoc(briefFile(), briefLine(), self, QSharedPointer<MemberDef>(),
+                  briefDescription(), true, false, "", true, false);
 
       if (rootNode && !rootNode->isEmpty()) {
          ol.startParagraph();
@@ -749,7 +749,7 @@ void GroupDef::writeBriefDescription(OutputList &ol)
          ol.writeString(" - ");
          ol.popGeneratorState();
 
-         ol.writeDoc(rootNode, self, QSharedPointer<MemberDef>());
+         ol.writeDoc(rootNode.data(), self, QSharedPointer<MemberDef>());
          ol.pushGeneratorState();
          ol.disable(OutputGenerator::RTF);
          ol.writeString(" \n");
@@ -766,7 +766,6 @@ void GroupDef::writeBriefDescription(OutputList &ol)
          ol.endParagraph();
       }
 
-      delete rootNode;
    }
 
    ol.writeSynopsis();
@@ -16,7 +16,10 @@
 *
 *************************************************************************/
 
+#include <QCryptographicHash>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QFileInfo>
 
 #include <math.h>
 
@@ -24,6 +27,7 @@
 
 #include <config.h>
 #include <lodepng.h>
+#include <message.h>
 
 typedef unsigned char  Byte;
 
@@ -203,7 +207,8 @@ static Color palette3[] = {
    { 0x00, 0x00, 0x00, 0xff }
 };
 
-Image::Image(int w, int h)
+// sets the colors of the palette derived from the html color style settings
+static bool initPalette()
 {
    static int hue   = Config::getInt("html-colorstyle-hue");
    static int sat   = Config::getInt("html-colorstyle-sat");
@@ -230,6 +235,15 @@ Image::Image(int w, int h)
    palette[3].green = (int)(green2 * 255.0);
    palette[3].blue  = (int)(blue2  * 255.0);
 
+   return true;
+}
+
+Image::Image(int w, int h)
+{
+   // set once, convert() reads the palette from the image writer threads
+   static bool paletteSet = initPalette();
+   (void) paletteSet;
+
    data = new uchar[w * h];
    memset(data, 0, w * h);
    width = w;
@@ -399,6 +413,21 @@ void Image::fillRect(int x, int y, int lwidth, int lheight, uchar colIndex, uint
    }
 }
 
+// sets the zlib effort from png-compression-level, 9 tests every earlier match in the window
+static void setCompression(LodePNG_Encoder &encoder)
+{
+   static const unsigned maxChainLength[] = { 0, 1, 2, 4, 8, 16, 32, 128, 512, 0 };
+   static const int level = Config::getInt("png-compression-level");
+
+   if (level == 0) {
+      // stored blocks, no compression
+      encoder.settings.zlibsettings.btype = 0;
+
+   } else {
+      encoder.settings.zlibsettings.maxChainLength = maxChainLength[level];
+   }
+}
+
 QByteArray Image::convert(int mode)
 {
    static bool useTransparency = Config::getBool("formula-transparent");
@@ -408,6 +437,7 @@ QByteArray Image::convert(int mode)
 
    LodePNG_Encoder encoder;
    LodePNG_Encoder_init(&encoder);
+   setCompression(encoder);
 
    int numCols;
 
@@ -423,10 +453,24 @@ QByteArray Image::convert(int mode)
       LodePNG_InfoColor_addPalette(&encoder.infoPng.color, pPal->red, pPal->green, pPal->blue, pPal->alpha);
    }
 
+   // at most 16 colors, two pixels are stored in each byte which halves the data to compress
+   QByteArray packed((width * height + 1) / 2, 0);
+   uchar *dest = reinterpret_cast<uchar *>(packed.data());
+
+   for (int i = 0; i < width * height; i++) {
+      if (i & 1) {
+         dest[i / 2] |= data[i] & 0x0f;
+      } else {
+         dest[i / 2] = (data[i] & 0x0f) << 4;
+      }
+   }
+
    encoder.infoPng.color.colorType = 3;
+   encoder.infoPng.color.bitDepth  = 4;
    encoder.infoRaw.color.colorType = 3;
+   encoder.infoRaw.color.bitDepth  = 4;
 
-   LodePNG_encode(&encoder, &buffer, &bufferSize, data, width, height);
+   LodePNG_encode(&encoder, &buffer, &bufferSize, dest, width, height);
 
    QByteArray retval = QByteArray( (const char *)buffer, bufferSize);
 
@@ -436,6 +480,28 @@ QByteArray Image::convert(int mode)
    return retval;
 }
 
+// increase when convert() encodes the same pixels differently
+static const int imageFormatVersion = 2;
+
+QByteArray Image::signature(int mode) const
+{
+   static bool useTransparency = Config::getBool("formula-transparent");
+   static const int level      = Config::getInt("png-compression-level");
+
+   int numCols = (mode == 0) ? 8 : 16;
+   const Color *pPal = mode == 0  ? palette  : useTransparency ? palette2 : palette3 ;
+
+   QCryptographicHash hash(QCryptographicHash::Md5);
+
+   // the encoding settings are included so a changed setting writes the image again
+   hash.addData(QByteArray::number(imageFormatVersion) + ":" + QByteArray::number(level) + "\n");
+   hash.addData(QByteArray::number(width) + "x" + QByteArray::number(height) + "\n");
+   hash.addData(reinterpret_cast<const char *>(pPal), numCols * sizeof(Color));
+   hash.addData(reinterpret_cast<const char *>(data), width * height);
+
+   return hash.result().toHex();
+}
+
 void ColoredImage::hsl2rgb(double h, double s, double l, double *pRed, double *pGreen, double *pBlue)
 {
    double v;
@@ -538,6 +604,7 @@ QByteArray ColoredImage::convert()
 
    LodePNG_Encoder encoder;
    LodePNG_Encoder_init(&encoder);
+   setCompression(encoder);
 
    // 2 = RGB 24 bit, 6 = RGBA 32 bit
    encoder.infoPng.color.colorType = m_hasAlpha ? 6 : 2;
@@ -554,3 +621,197 @@ QByteArray ColoredImage::convert()
 
    return retval;
 }
+
+class ImageWriterThread : public QThread
+{
+ public:
+   ImageWriterThread(ImageWriter *writer)
+      : m_writer(writer)
+   { }
+
+   void run() override {
+      m_writer->runJobs();
+   }
+
+ private:
+   ImageWriter *m_writer;
+};
+
+ImageWriter::ImageWriter()
+   : m_running(0), m_written(0), m_skipped(0), m_encodedBytes(0), m_encodeTime(0), m_stop(false)
+{
+}
+
+ImageWriter *ImageWriter::instance()
+{
+   static ImageWriter retval;
+   return &retval;
+}
+
+void ImageWriter::write(const QString &fileName, QSharedPointer<Image> image, int mode)
+{
+   Job job;
+
+   job.fileName  = fileName;
+   job.signature = image->signature(mode);
+   job.image     = image;
+   job.mode      = mode;
+
+   QFile f(fileName + ".md5");
+   QFileInfo fi(fileName);
+
+   if (fi.exists() && fi.size() > 0 && f.open(QIODevice::ReadOnly) && f.readAll() == job.signature) {
+      // unchanged since the previous run
+      QMutexLocker locker(&m_mutex);
+      ++m_skipped;
+
+      return;
+   }
+
+   QMutexLocker locker(&m_mutex);
+
+   if (m_workers.isEmpty()) {
+      int numThreads = qMax(1, qMin(QThread::idealThreadCount(), 32));
+
+      for (int i = 0; i < numThreads; ++i) {
+         QThread *thread = new ImageWriterThread(this);
+         thread->start();
+
+         if (thread->isRunning()) {
+            m_workers.append(thread);
+         } else {
+            // no more threads available
+            delete thread;
+         }
+      }
+   }
+
+   if (m_workers.isEmpty()) {
+      locker.unlock();
+      writeFile(job);
+
+      locker.relock();
+      ++m_written;
+
+      return;
+   }
+
+   // limit the memory used by images which are not written yet
+   while (m_jobs.count() >= 4 * m_workers.count()) {
+      m_jobDone.wait(&m_mutex);
+   }
+
+   m_jobs.enqueue(job);
+   ++m_running;
+
+   m_jobReady.wakeOne();
+}
+
+void ImageWriter::finish()
+{
+   {
+      QMutexLocker locker(&m_mutex);
+
+      while (m_running > 0) {
+         m_jobDone.wait(&m_mutex);
+      }
+
+      m_stop = true;
+      m_jobReady.wakeAll();
+   }
+
+   for (auto thread : m_workers) {
+      thread->wait();
+      delete thread;
+   }
+
+   m_workers.clear();
+   m_stop = false;
+}
+
+bool ImageWriter::nextJob(Job &job)
+{
+   QMutexLocker locker(&m_mutex);
+
+   while (! m_stop && m_jobs.isEmpty()) {
+      m_jobReady.wait(&m_mutex);
+   }
+
+   if (m_jobs.isEmpty()) {
+      return false;
+   }
+
+   job = m_jobs.dequeue();
+   m_jobDone.wakeAll();
+
+   return true;
+}
+
+void ImageWriter::jobDone()
+{
+   QMutexLocker locker(&m_mutex);
+
+   --m_running;
+   ++m_written;
+
+   m_jobDone.wakeAll();
+}
+
+void ImageWriter::runJobs()
+{
+   Job job;
+
+   while (nextJob(job)) {
+      writeFile(job);
+      job = Job();
+
+      jobDone();
+   }
+}
+
+void ImageWriter::writeFile(const Job &job)
+{
+   QFile f(job.fileName);
+
+   if (! f.open(QIODevice::WriteOnly)) {
+      err("Unable to open file for writing %s, error: %d\n", csPrintable(job.fileName), f.error());
+      return;
+   }
+
+   QElapsedTimer timer;
+   timer.start();
+
+   QByteArray png = job.image->convert(job.mode);
+   qint64 elapsed = timer.nsecsElapsed();
+
+   f.write(png);
+   f.close();
+
+   {
+      QMutexLocker locker(&m_mutex);
+
+      m_encodedBytes += png.size();
+      m_encodeTime   += elapsed;
+   }
+
+   // written last, a missing or partial image is never taken as unchanged
+   QFile sigFile(job.fileName + ".md5");
+
+   if (sigFile.open(QIODevice::WriteOnly)) {
+      sigFile.write(job.signature);
+   }
+}
+
+void ImageWriter::printStatistics() const
+{
+   QMutexLocker locker(&m_mutex);
+
+   if (m_written + m_skipped > 0) {
+      msg("Diagram images: %d written, %d unchanged\n", m_written, m_skipped);
+   }
+
+   if (m_written > 0) {
+      msg("Diagram images: %.1f KB and %.2f ms per encoded image\n", m_encodedBytes / 1024.0 / m_written,
+            m_encodeTime / 1000000.0 / m_written);
+   }
+}
@@ -20,6 +20,13 @@
 #define IMAGE_H
 
 #include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
 
 /** Class representing a bitmap image generated by DoxyPress. */
 class Image
@@ -41,6 +48,9 @@ class Image
 
    QByteArray convert(int mode = 0);
 
+   /** Returns a hash of the size, the pixels and the palette used by convert() */
+   QByteArray signature(int mode = 0) const;
+
    uint getWidth() const {
       return width;
    }
@@ -81,4 +91,55 @@ class ColoredImage
    bool m_hasAlpha;
 };
 
+/** Encodes images and writes the PNG files on worker threads. An image is skipped when the
+ *  signature stored by a previous run is equal and the file exists.
+ */
+class ImageWriter
+{
+ public:
+   static ImageWriter *instance();
+
+   /** Writes \a image to \a fileName, the image must not be changed afterwards */
+   void write(const QString &fileName, QSharedPointer<Image> image, int mode = 0);
+
+   /** Waits until all images are written */
+   void finish();
+
+   void printStatistics() const;
+
+ private:
+   struct Job {
+      QString fileName;
+      QByteArray signature;
+      QSharedPointer<Image> image;
+      int mode;
+   };
+
+   ImageWriter();
+
+   bool nextJob(Job &job);
+   void jobDone();
+   void runJobs();
+
+   void writeFile(const Job &job);
+
+   QQueue<Job>      m_jobs;
+   QList<QThread *> m_workers;
+
+   int m_running;
+   int m_written;
+   int m_skipped;
+
+   qint64 m_encodedBytes;
+   qint64 m_encodeTime;
+
+   bool m_stop;
+
+   QWaitCondition  m_jobReady;
+   QWaitCondition  m_jobDone;
+   mutable QMutex  m_mutex;
+
+   friend class ImageWriterThread;
+};
+
 #endif
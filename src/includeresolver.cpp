@@ -0,0 +1,167 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#include <QDir>
+#include <QFileInfo>
+
+#include <includeresolver.h>
+
+#include <config.h>
+#include <message.h>
+#include <util.h>
+
+// directory part of an absolute name, i is the position of the last slash
+static QString parentPath(const QString &absName, int i)
+{
+   QString retval = absName.left(i);
+
+   if (retval.isEmpty() || retval.endsWith(':')) {
+      // root directory
+      retval += '/';
+   }
+
+   return retval;
+}
+
+IncludeResolver::IncludeResolver()
+   : m_hits(0), m_misses(0)
+{
+}
+
+IncludeResolver *IncludeResolver::instance()
+{
+   static IncludeResolver retval;
+   return &retval;
+}
+
+QString IncludeResolver::entryName(const QString &name) const
+{
+#if defined(_WIN32) || defined(__MACOSX__)
+   // Windows or MacOSX
+   return name.toLower();
+#else
+   // Unix
+   return name;
+#endif
+}
+
+const IncludeResolver::DirListing &IncludeResolver::listing(const QString &dirName)
+{
+   auto iter = m_dirs.find(dirName);
+
+   if (iter != m_dirs.end()) {
+      return iter.value();
+   }
+
+   DirListing dir;
+   QDir d(dirName);
+
+   if (d.exists()) {
+      dir.isDir = true;
+
+      QDir::Filters filters = QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot;
+
+      for (const auto &fi : d.entryInfoList(filters)) {
+         if (fi.isDir()) {
+            dir.dirs.insert(entryName(fi.fileName()));
+         } else {
+            dir.files.insert(entryName(fi.fileName()));
+         }
+      }
+   }
+
+   return m_dirs.insert(dirName, dir).value();
+}
+
+QString IncludeResolver::find(const QString &dirName, const QString &fileName)
+{
+   QPair<QString, QString> key(dirName, fileName);
+
+   auto iter = m_found.find(key);
+
+   if (iter != m_found.end()) {
+      ++m_hits;
+      return iter.value();
+   }
+
+   ++m_misses;
+
+   QString retval;
+   QString absName = QDir::cleanPath(QFileInfo(dirName).absoluteFilePath() + "/" + fileName);
+
+   int i = absName.lastIndexOf('/');
+
+   if (i != -1 && i + 1 < absName.length()) {
+      const DirListing &dir = listing(parentPath(absName, i));
+      QString name = entryName(absName.mid(i + 1));
+
+      if (dir.files.contains(name) || dir.dirs.contains(name)) {
+         retval = absName;
+      }
+
+   } else if (QFileInfo(absName).exists()) {
+      // root directory
+      retval = absName;
+   }
+
+   m_found.insert(key, retval);
+
+   return retval;
+}
+
+bool IncludeResolver::isFile(const QString &fileName)
+{
+   QFileInfo fi(fileName);
+   QString absName = find(fi.absolutePath(), fi.fileName());
+
+   if (absName.isEmpty()) {
+      return false;
+   }
+
+   int i = absName.lastIndexOf('/');
+
+   if (i == -1 || i + 1 == absName.length()) {
+      return false;
+   }
+
+   return listing(parentPath(absName, i)).files.contains(entryName(absName.mid(i + 1)));
+}
+
+bool IncludeResolver::isExcluded(const QString &fileName)
+{
+   static const QStringList exclPatterns = Config::getList("exclude-patterns");
+
+   auto iter = m_excluded.find(fileName);
+
+   if (iter != m_excluded.end()) {
+      return iter.value();
+   }
+
+   bool retval = patternMatch(QFileInfo(fileName), exclPatterns);
+   m_excluded.insert(fileName, retval);
+
+   return retval;
+}
+
+void IncludeResolver::printStatistics() const
+{
+   if (m_hits + m_misses > 0) {
+      msg("Include resolver: %d directories listed, %d hits, %d misses\n", m_dirs.count(), m_hits, m_misses);
+   }
+}
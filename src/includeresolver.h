@@ -0,0 +1,78 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#ifndef INCLUDERESOLVER_H
+#define INCLUDERESOLVER_H
+
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QString>
+
+/** Resolves the names used in include directives to absolute file names.
+ *
+ *  Each directory is listed once, after that checking if a file exists is a
+ *  lookup in memory instead of a call to the file system. The absolute name
+ *  found for a directory and a spelled name is memoized, including the names
+ *  which were not found. The exclude-patterns are matched once per file name.
+ *
+ *  Used by the preprocessor to open include files and to link them to their
+ *  FileDef. Directories are expected not to change while DoxyPress runs.
+ */
+class IncludeResolver
+{
+ public:
+   static IncludeResolver *instance();
+
+   /** Returns the absolute name of \a fileName relative to the directory \a dirName or an empty
+    *  string if there is no such file or directory
+    */
+   QString find(const QString &dirName, const QString &fileName);
+
+   /** Returns true if \a fileName exists and is not a directory */
+   bool isFile(const QString &fileName);
+
+   /** Returns true if \a fileName matches one of the exclude-patterns */
+   bool isExcluded(const QString &fileName);
+
+   void printStatistics() const;
+
+ private:
+   IncludeResolver();
+
+   struct DirListing {
+      DirListing() : isDir(false) {}
+
+      bool isDir;
+      QSet<QString> files;
+      QSet<QString> dirs;
+   };
+
+   const DirListing &listing(const QString &dirName);
+   QString entryName(const QString &name) const;
+
+   QHash<QString, DirListing> m_dirs;
+   QHash<QPair<QString, QString>, QString> m_found;
+   QHash<QString, bool> m_excluded;
+
+   int m_hits;
+   int m_misses;
+};
+
+#endif
@@ -0,0 +1,133 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#include <input_queue.h>
+
+#include <util.h>
+
+InputFileQueue::InputFileQueue(const QStringList &fileList, int numThreads, bool filter, bool isSourceCode)
+   : m_fileList(fileList), m_items(fileList.count()), m_filter(filter), m_isSourceCode(isSourceCode),
+     m_nextIndex(0), m_takenIndex(0), m_abort(false)
+{
+   if (numThreads == 0) {
+      numThreads = qMax(2, QThread::idealThreadCount());
+   }
+
+   numThreads   = qMin(numThreads, qMin(32, fileList.count()));
+   m_windowSize = 4 * qMax(1, numThreads);
+
+   if (numThreads > 1) {
+      for (int i = 0; i < numThreads; ++i) {
+         InputReaderThread *thread = new InputReaderThread(this);
+         thread->start();
+
+         if (thread->isRunning()) {
+            m_workers.append(thread);
+         } else {
+            // no more threads available
+            delete thread;
+         }
+      }
+   }
+}
+
+InputFileQueue::~InputFileQueue()
+{
+   {
+      QMutexLocker locker(&m_mutex);
+
+      m_abort = true;
+      m_windowOpen.wakeAll();
+   }
+
+   for (auto thread : m_workers) {
+      thread->wait();
+      delete thread;
+   }
+}
+
+QString InputFileQueue::take(int index)
+{
+   if (m_workers.isEmpty()) {
+      // single threaded, read the file on the calling thread
+      return readFile(index);
+   }
+
+   QMutexLocker locker(&m_mutex);
+
+   while (! m_items[index].ready) {
+      m_itemReady.wait(&m_mutex);
+   }
+
+   QString retval = std::move(m_items[index].contents);
+   m_items[index].contents = QString();
+
+   m_takenIndex = qMax(m_takenIndex, index + 1);
+   m_windowOpen.wakeAll();
+
+   return retval;
+}
+
+int InputFileQueue::nextIndex()
+{
+   QMutexLocker locker(&m_mutex);
+
+   while (! m_abort && m_nextIndex < m_items.count() && m_nextIndex >= m_takenIndex + m_windowSize) {
+      // limit how many files are held in memory
+      m_windowOpen.wait(&m_mutex);
+   }
+
+   if (m_abort || m_nextIndex >= m_items.count()) {
+      return -1;
+   }
+
+   return m_nextIndex++;
+}
+
+QString InputFileQueue::readFile(int index) const
+{
+   QString retval;
+   readInputFile(m_fileList[index], retval, m_filter, m_isSourceCode);
+
+   return retval;
+}
+
+void InputFileQueue::store(int index, QString contents)
+{
+   QMutexLocker locker(&m_mutex);
+
+   m_items[index].contents = std::move(contents);
+   m_items[index].ready    = true;
+
+   m_itemReady.wakeAll();
+}
+
+InputReaderThread::InputReaderThread(InputFileQueue *queue)
+   : m_queue(queue)
+{
+}
+
+void InputReaderThread::run()
+{
+   int index;
+
+   while ((index = m_queue->nextIndex()) != -1) {
+      m_queue->store(index, m_queue->readFile(index));
+   }
+}
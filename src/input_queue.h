@@ -0,0 +1,99 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+class InputReaderThread;
+
+/** Reads the input files on worker threads ahead of the parsers.
+ *
+ *  The lex based scanners are not reentrant so files are still scanned one at
+ *  a time in input order. Reading, filtering and transcoding a file does not
+ *  touch scanner state and is done by the workers while the previous file is
+ *  being parsed. At most a fixed number of files are kept in memory.
+ */
+class InputFileQueue
+{
+ public:
+   InputFileQueue(const QStringList &fileList, int numThreads, bool filter = true, bool isSourceCode = false);
+   ~InputFileQueue();
+
+   /** Returns the contents of the file at position \a index in the file list,
+    *  waits until a worker has read the file. Each index may only be taken once.
+    */
+   QString take(int index);
+
+   int threadCount() const {
+      return m_workers.count();
+   }
+
+ private:
+   struct Item {
+      QString contents;
+      bool    ready = false;
+   };
+
+   // called by the worker threads
+   int  nextIndex();
+   void store(int index, QString contents);
+
+   QString readFile(int index) const;
+
+   QStringList     m_fileList;
+   QVector<Item>   m_items;
+
+   bool m_filter;
+   bool m_isSourceCode;
+
+   int m_nextIndex;
+   int m_takenIndex;
+   int m_windowSize;
+
+   bool m_abort;
+
+   QWaitCondition  m_itemReady;
+   QWaitCondition  m_windowOpen;
+   mutable QMutex  m_mutex;
+
+   QList<InputReaderThread *> m_workers;
+
+   friend class InputReaderThread;
+};
+
+/** Worker thread which reads input files for an InputFileQueue */
+class InputReaderThread : public QThread
+{
+ public:
+   InputReaderThread(InputFileQueue *queue);
+   void run() override;
+
+ private:
+   InputFileQueue *m_queue;
+};
+
+#endif
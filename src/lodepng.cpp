@@ -1211,7 +1211,8 @@ static void addLengthDistance(uivector *values, size_t length, size_t distance)
 #define encodeLZ77 encodeLZ77_brute
 /*the "brute force" version of the encodeLZ7 algorithm, not used anymore, kept here for reference*/
 
-static unsigned encodeLZ77_brute(uivector *out, const unsigned char *in, size_t size, unsigned windowSize)
+static unsigned encodeLZ77_brute(uivector *out, const unsigned char *in, size_t size, unsigned windowSize,
+                                 unsigned maxChainLength)
 {
    size_t pos;
    /*using pointer instead of vector for input makes it faster when NOT using optimization when compiling; no influence if optimization is used*/
@@ -1271,11 +1272,16 @@ static unsigned encodeLZ77_brute(uivector *out, const unsigned char *in, size_t
       size_t length = 0, offset = 0; /*the length and offset found for the current position*/
       size_t max_offset = pos < windowSize ? pos : windowSize; /*how far back to test*/
       size_t current_offset;
+      unsigned chainLength = 0; /*number of candidates tested for the current position*/
 
       /**search for the longest string**/
       for (current_offset = 1; current_offset < max_offset; current_offset++) { /*search backwards through all possible distances (=offsets)*/
          size_t backpos = pos - current_offset;
          if (in[backpos] == in[pos]) {
+            if (maxChainLength != 0 && chainLength++ >= maxChainLength) {
+               break;   /*the nearest candidates were tested, a longer match further back is not worth the time*/
+            }
+
             /*test the next characters*/
             size_t current_length = 1;
             size_t backtest = backpos + 1;
@@ -1340,7 +1346,7 @@ static unsigned getHash(const unsigned char *data, size_t size, size_t pos)
 }
 
 /*LZ77-encode the data using a hash table technique to let it encode faster. Return value is error code*/
-static unsigned encodeLZ77(uivector *out, const unsigned char *in, size_t size, unsigned windowSize)
+static unsigned encodeLZ77(uivector *out, const unsigned char *in, size_t size, unsigned windowSize, unsigned maxChainLength)
 {
    /**generate hash table**/
    vector table; /*HASH_NUM_VALUES uivectors; this represents what would be an std::vector<std::vector<unsigned> > in C++*/
@@ -1508,6 +1514,21 @@ static void writeLZ77data(size_t *bp, ucvector *out, const uivector *lz77_encode
    }
 }
 
+/*LZ77 output of deflateDynamic, kept for each thread so the memory is reused by the next image*/
+struct LZ77Buffer {
+   uivector data;
+
+   LZ77Buffer() {
+      uivector_init(&data);
+   }
+
+   ~LZ77Buffer() {
+      uivector_cleanup(&data);
+   }
+};
+
+static thread_local LZ77Buffer s_lz77Buffer;
+
 static unsigned deflateDynamic(ucvector *out, const unsigned char *data, size_t datasize, const LodeZlib_DeflateSettings *settings)
 {
    /*
@@ -1522,7 +1543,7 @@ static unsigned deflateDynamic(ucvector *out, const unsigned char *data, size_t
 
    unsigned error = 0;
 
-   uivector lz77_encoded;
+   uivector &lz77_encoded = s_lz77Buffer.data;
    HuffmanTree codes; /*tree for literal values and length codes*/
    HuffmanTree codesD; /*tree for distance codes*/
    HuffmanTree codelengthcodes;
@@ -1537,7 +1558,7 @@ static unsigned deflateDynamic(ucvector *out, const unsigned char *data, size_t
    size_t numcodes, numcodesD, i, bp = 0; /*the bit pointer*/
    unsigned HLIT, HDIST, HCLEN;
 
-   uivector_init(&lz77_encoded);
+   lz77_encoded.size = 0;
    HuffmanTree_init(&codes);
    HuffmanTree_init(&codesD);
    HuffmanTree_init(&codelengthcodes);
@@ -1550,7 +1571,7 @@ static unsigned deflateDynamic(ucvector *out, const unsigned char *data, size_t
 
    while (!error) { /*the goto-avoiding while construct: break out to go to the cleanup phase, a break at the end makes sure the while is never repeated*/
       if (settings->useLZ77) {
-         error = encodeLZ77(&lz77_encoded, data, datasize, settings->windowSize); /*LZ77 encoded*/
+         error = encodeLZ77(&lz77_encoded, data, datasize, settings->windowSize, settings->maxChainLength); /*LZ77 encoded*/
          if (error) {
             break;
          }
@@ -1723,7 +1744,6 @@ static unsigned deflateDynamic(ucvector *out, const unsigned char *data, size_t
    }
 
    /*cleanup*/
-   uivector_cleanup(&lz77_encoded);
    HuffmanTree_cleanup(&codes);
    HuffmanTree_cleanup(&codesD);
    HuffmanTree_cleanup(&codelengthcodes);
@@ -1759,7 +1779,7 @@ static unsigned deflateFixed(ucvector *out, const unsigned char *data, size_t da
    if (settings->useLZ77) { /*LZ77 encoded*/
       uivector lz77_encoded;
       uivector_init(&lz77_encoded);
-      error = encodeLZ77(&lz77_encoded, data, datasize, settings->windowSize);
+      error = encodeLZ77(&lz77_encoded, data, datasize, settings->windowSize, settings->maxChainLength);
       if (!error) {
          writeLZ77data(&bp, out, &lz77_encoded, &codes, &codesD);
       }
@@ -1961,9 +1981,10 @@ void LodeZlib_DeflateSettings_init(LodeZlib_DeflateSettings *settings)
    settings->btype = 2; /*compress with dynamic huffman tree (not in the mathematical sense, just not the predefined one)*/
    settings->useLZ77 = 1;
    settings->windowSize = 2048; /*this is a good tradeoff between speed and compression ratio*/
+   settings->maxChainLength = 0;
 }
 
-const LodeZlib_DeflateSettings LodeZlib_defaultDeflateSettings = {2, 1, 2048};
+const LodeZlib_DeflateSettings LodeZlib_defaultDeflateSettings = {2, 1, 2048, 0};
 
 #endif /*LODEPNG_COMPILE_ENCODER*/
 
@@ -4346,6 +4367,34 @@ static void addPaddingBits(unsigned char *out, const unsigned char *in, size_t o
    unsigned y;
    size_t diff = olinebits - ilinebits;
    size_t obp = 0, ibp = 0; /*bit pointers*/
+
+   if (ilinebits % 4 == 0 && olinebits % 8 == 0) {
+      /*4 bit palette images with an odd width, input lines start on a byte or on a nibble boundary*/
+      size_t nibbles = ilinebits / 4;
+      for (y = 0; y < h; y++) {
+         size_t start = y * nibbles;
+         const unsigned char *src = &in[start / 2];
+         unsigned char *line = &out[y * (olinebits / 8)];
+         size_t x;
+         if (start % 2 == 0) {
+            for (x = 0; x < nibbles / 2; x++) {
+               line[x] = src[x];
+            }
+            if (nibbles % 2) {
+               line[x] = src[x] & 0xf0;
+            }
+         } else {
+            for (x = 0; x < nibbles / 2; x++) {
+               line[x] = (unsigned char)((src[x] << 4) | (src[x + 1] >> 4));
+            }
+            if (nibbles % 2) {
+               line[x] = (unsigned char)(src[x] << 4);
+            }
+         }
+      }
+      return;
+   }
+
    for (y = 0; y < h; y++) {
       size_t x;
       for (x = 0; x < ilinebits; x++) {
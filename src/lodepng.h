@@ -57,6 +57,7 @@ typedef struct LodeZlib_DeflateSettings { /*deflate = compress*/
    unsigned btype; /*the block type for LZ*/
    unsigned useLZ77; /*whether or not to use LZ77*/
    unsigned windowSize; /*the maximum is 32768*/
+   unsigned maxChainLength; /*the maximum number of earlier positions tested for a match, 0 tests all positions in the window*/
 } LodeZlib_DeflateSettings;
 
 extern const LodeZlib_DeflateSettings LodeZlib_defaultDeflateSettings;
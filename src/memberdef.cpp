@@ -1783,14 +1783,14 @@ void MemberDef::writeDeclaration(OutputList &ol, QSharedPointer<ClassDef> cd, QS
    // write brief description
    if (! briefDescription().isEmpty() && briefMemberDesc) {
 
-      DocRoot *rootNode = validatingParseDoc(briefFile(), briefLine(), getOuterScope() ? getOuterScope() : d,
+      QSharedPointer<DocRoot> rootNode = cachedParseDoc(briefFile(), briefLine(), getOuterScope() ? getOuterScope() : d,
                   self, briefDescription(), true, false, "", true, false);
 
       if (rootNode && ! rootNode->isEmpty()) {
          ol.startMemberDescription(anchor(), inheritId);
 
          // write the brief description
-         ol.writeDoc(rootNode, getOuterScope() ? getOuterScope() : d, self);
+         ol.writeDoc(rootNode.data(), getOuterScope() ? getOuterScope() : d, self);
 
          if (detailsVisible) {
 
@@ -1825,7 +1825,6 @@ void MemberDef::writeDeclaration(OutputList &ol, QSharedPointer<ClassDef> cd, QS
          ol.popGeneratorState();
          ol.endMemberDescription();
       }
-      delete rootNode;
    }
 
    ol.endMemberDeclaration(anchor(), inheritId);
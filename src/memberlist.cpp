@@ -384,12 +384,12 @@ void MemberList::writePlainDeclarations(OutputList &ol, QSharedPointer<ClassDef>
 
                   if (! md->briefDescription().isEmpty() && briefMemberDesc) {
 
-                     DocRoot *rootNode = validatingParseDoc(md->briefFile(), md->briefLine(),
-                                            cd, md, md->briefDescription(), true, false, "", true, false);
+                     QSharedPointer<DocRoot> rootNode = cachedParseDoc(md->briefFile(), md->briefLine(),
+                                 cd, md, md->briefDescription(), true, false, "", true, false);
 
                      if (rootNode && ! rootNode->isEmpty()) {
                         ol.startMemberDescription(md->anchor());
-                        ol.writeDoc(rootNode, cd, md);
+                        ol.writeDoc(rootNode.data(), cd, md);
 
                         if (md->isDetailedSectionLinkable()) {
                            ol.disableAllBut(OutputGenerator::Html);
@@ -401,7 +401,6 @@ void MemberList::writePlainDeclarations(OutputList &ol, QSharedPointer<ClassDef>
                         }
                         ol.endMemberDescription();
                      }
-                     delete rootNode;
                   }
 
                   ol.endMemberDeclaration(md->anchor(), inheritId);
@@ -19,6 +19,8 @@
 #include <stdarg.h>
 #include <stdio.h>
 
+#include <mutex>
+
 #include <message.h>
 
 #include <config.h>
@@ -28,6 +30,10 @@
 int Debug::curMask     = 0;
 int Debug::curPriority = 0;
 
+// messages are written by the threads reading input files and writing output as well,
+// a message is written as a whole before the next one starts
+static std::recursive_mutex s_messageMutex;
+
 QHash<QString, Debug::DebugMask> debugMap();
 QHash<QString, Debug::DebugMask> Debug::m_map = debugMap();
 
@@ -110,6 +116,8 @@ void Debug::print(DebugMask mask, int data, const QString &fmt, ...)
 {
    if (curMask & mask) {
       if (curPriority >= data) {
+         std::lock_guard<std::recursive_mutex> lock(s_messageMutex);
+
          va_list args;
          va_start(args, fmt);
          vfprintf(stdout, fmt.constData(), args);
@@ -145,6 +153,8 @@ void initWarningFormat()
 
 static void format_warn(const QString &file, int line, const QString &text)
 {
+   std::lock_guard<std::recursive_mutex> lock(s_messageMutex);
+
    QString fileSubst = file;
 
    if (file.isEmpty() ) {
@@ -200,6 +210,8 @@ static void warn_internal(const QString &tag, const QString &file, int line, con
 // **
 void err(const QString &fmt, ...)
 {
+   std::lock_guard<std::recursive_mutex> lock(s_messageMutex);
+
    va_list args;
    va_start(args, fmt);
 
@@ -213,6 +225,8 @@ void err(const QString &fmt, ...)
 
 void errAll(const QString &fmt, ...)
 {
+   std::lock_guard<std::recursive_mutex> lock(s_messageMutex);
+
    va_list args;
    va_start(args, fmt);
 
@@ -231,6 +245,8 @@ void errAll(const QString &fmt, ...)
 
 void errNoPrefix(const QString &fmt, ...)
 {
+   std::lock_guard<std::recursive_mutex> lock(s_messageMutex);
+
    va_list args;
    va_start(args, fmt);
 
@@ -242,6 +258,8 @@ void errNoPrefix(const QString &fmt, ...)
 
 void errNoPrefixAll(const QString &fmt, ...)
 {
+   std::lock_guard<std::recursive_mutex> lock(s_messageMutex);
+
    va_list args;
    va_start(args, fmt);
 
@@ -258,6 +276,8 @@ void errNoPrefixAll(const QString &fmt, ...)
 
 void warnMsg(const QString &fmt, ...)
 {
+   std::lock_guard<std::recursive_mutex> lock(s_messageMutex);
+
    va_list args;
    va_start(args, fmt);
 
@@ -271,6 +291,8 @@ void warnMsg(const QString &fmt, ...)
 
 void warnAll(const QString &fmt, ...)
 {
+   std::lock_guard<std::recursive_mutex> lock(s_messageMutex);
+
    va_list args;
    va_start(args, fmt);
 
@@ -292,6 +314,8 @@ void warnAll(const QString &fmt, ...)
 void msg(const QString &fmt, ...)
 {
    if (! Config::getBool("quiet")) {
+      std::lock_guard<std::recursive_mutex> lock(s_messageMutex);
+
       va_list args;
       va_start(args, fmt);
 
@@ -356,6 +380,8 @@ void warn_undoc(const QString &file, int line, const QString &fmt, ...)
 // **
 void warn_uncond(const QString &fmt, ...)
 {
+   std::lock_guard<std::recursive_mutex> lock(s_messageMutex);
+
    va_list args;
    va_start(args, fmt);
 
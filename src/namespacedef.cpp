@@ -357,8 +357,8 @@ void NamespaceDef::writeBriefDescription(OutputList &ol)
    QSharedPointer<NamespaceDef> self = sharedFrom(this);
 
    if (hasBriefDescription()) {
-      DocRoot *rootNode = validatingParseDoc(briefFile(), briefLine(), self, QSharedPointer<MemberDef>(),
-                                             briefDescription(), true, false, "", true, false);
+      QSharedPointer<DocRoot> rootNode = cachedParseDoc(briefFile(), briefLine(), self, QSharedPointer<MemberDef>(),
+                  briefDescription(), true, false, "", true, false);
 
       if (rootNode && ! rootNode->isEmpty()) {
          ol.startParagraph();
@@ -368,7 +368,7 @@ void NamespaceDef::writeBriefDescription(OutputList &ol)
          ol.writeString(" - ");
          ol.popGeneratorState();
 
-         ol.writeDoc(rootNode, self, QSharedPointer<MemberDef>());
+         ol.writeDoc(rootNode.data(), self, QSharedPointer<MemberDef>());
          ol.pushGeneratorState();
          ol.disable(OutputGenerator::RTF);
          ol.writeString(" \n");
@@ -383,7 +383,6 @@ void NamespaceDef::writeBriefDescription(OutputList &ol)
          ol.popGeneratorState();
          ol.endParagraph();
       }
-      delete rootNode;
 
       // FIXME:PARA
       //ol.pushGeneratorState();
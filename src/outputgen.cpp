@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <cassert>
 
+#include <config.h>
 #include <doxy_globals.h>
 #include <outputgen.h>
 #include <message.h>
@@ -36,10 +37,22 @@ OutputGenerator::~OutputGenerator()
 
 void OutputGenerator::startPlainFile(const QString &name)
 {
+   static const bool asyncWrite = Config::getBool("output-async-write");
+
    m_fileName = m_dir + "/" + name;
+
+   if (asyncWrite) {
+      // file is written by the OutputFileWriter when the page is complete
+      m_buffer.setData(QByteArray());
+      m_buffer.open(QIODevice::WriteOnly);
+
+      m_textStream.setDevice(&m_buffer);
+      return;
+   }
+
    m_file.setFileName(m_fileName);
 
-   if (! m_file.open(QIODevice::WriteOnly)) {   
+   if (! m_file.open(QIODevice::WriteOnly)) {
       err("Unable to open file for writing %s, error: %d\n", csPrintable(m_fileName), m_file.error());
       Doxy_Work::stopDoxyPress();
    }
@@ -49,14 +62,104 @@ void OutputGenerator::startPlainFile(const QString &name)
 
 void OutputGenerator::endPlainFile()
 {
+   m_textStream.flush();
    m_textStream.setDevice(0);
 
-   m_fileName = "";
+   if (m_buffer.isOpen()) {
+      m_buffer.close();
 
-   m_file.close();
+      OutputFileWriter::instance()->enqueue(m_fileName, m_buffer.data());
+      m_buffer.setData(QByteArray());
+
+   } else {
+      m_file.close();
+   }
+
+   m_fileName = "";
    m_file.setFileName(m_fileName);
 }
 
+OutputFileWriter *OutputFileWriter::m_theInstance = nullptr;
+
+OutputFileWriter *OutputFileWriter::instance()
+{
+   if (m_theInstance == nullptr) {
+      m_theInstance = new OutputFileWriter;
+      m_theInstance->start();
+   }
+
+   return m_theInstance;
+}
+
+OutputFileWriter::OutputFileWriter()
+   : m_queuedSize(0), m_busy(false), m_failed(false)
+{
+}
+
+void OutputFileWriter::enqueue(const QString &fileName, QByteArray data)
+{
+   // limit the memory used by pages which are not written yet
+   static const qint64 maxQueuedSize = 64 * 1024 * 1024;
+
+   QMutexLocker locker(&m_mutex);
+
+   while (! m_queue.isEmpty() && m_queuedSize + data.size() > maxQueuedSize) {
+      m_bufferNotFull.wait(&m_mutex);
+   }
+
+   m_queuedSize += data.size();
+   m_queue.enqueue(qMakePair(fileName, std::move(data)));
+   m_bufferNotEmpty.wakeAll();
+}
+
+void OutputFileWriter::waitForFinished()
+{
+   QMutexLocker locker(&m_mutex);
+
+   while (! m_queue.isEmpty() || m_busy) {
+      m_bufferEmpty.wait(&m_mutex);
+   }
+
+   if (m_failed) {
+      locker.unlock();
+      Doxy_Work::stopDoxyPress();
+   }
+}
+
+void OutputFileWriter::run()
+{
+   while (true) {
+      QPair<QString, QByteArray> item;
+
+      {
+         QMutexLocker locker(&m_mutex);
+
+         while (m_queue.isEmpty()) {
+            m_busy = false;
+            m_bufferEmpty.wakeAll();
+
+            // wait until a page is added to the queue
+            m_bufferNotEmpty.wait(&m_mutex);
+         }
+
+         item   = m_queue.dequeue();
+         m_busy = true;
+
+         m_queuedSize -= item.second.size();
+         m_bufferNotFull.wakeAll();
+      }
+
+      QFile f(item.first);
+
+      if (! f.open(QIODevice::WriteOnly) || f.write(item.second) != item.second.size()) {
+         err("Unable to open file for writing %s, error: %d\n", csPrintable(item.first), f.error());
+
+         QMutexLocker locker(&m_mutex);
+         m_failed = true;
+      }
+   }
+}
+
 void OutputGenerator::pushGeneratorState()
 {
    genStack.push( isEnabled() );   
@@ -19,9 +19,15 @@
 #ifndef OUTPUTGEN_H
 #define OUTPUTGEN_H
 
+#include <QBuffer>
 #include <QFile>
+#include <QMutex>
+#include <QPair>
+#include <QQueue>
 #include <QStack>
 #include <QTextStream>
+#include <QThread>
+#include <QWaitCondition>
 
 #include <index.h>
 #include <section.h>
@@ -299,6 +305,40 @@ class BaseOutputDocInterface : public CodeOutputInterface
    virtual void endSubsubsection() = 0;
 };
 
+/** Writes finished output files to disk on a background thread.
+ *
+ *  Pages are rendered into memory by the output generators. Files are written
+ *  in the order they were queued, waitForFinished() must be called before any
+ *  generated file is read back. enqueue() blocks while the pages waiting to be
+ *  written use more than a fixed amount of memory.
+ */
+class OutputFileWriter : public QThread
+{
+ public:
+   static OutputFileWriter *instance();
+
+   void enqueue(const QString &fileName, QByteArray data);
+   void waitForFinished();
+
+   void run() override;
+
+ private:
+   OutputFileWriter();
+
+   QQueue<QPair<QString, QByteArray>> m_queue;
+   qint64 m_queuedSize;
+
+   QWaitCondition m_bufferNotEmpty;
+   QWaitCondition m_bufferNotFull;
+   QWaitCondition m_bufferEmpty;
+   QMutex         m_mutex;
+
+   bool m_busy;
+   bool m_failed;
+
+   static OutputFileWriter *m_theInstance;
+};
+
 /** Abstract output generator.
  *
  *  Subclass this class to add support for a new output format
@@ -474,6 +514,7 @@ class OutputGenerator : public BaseOutputDocInterface
  protected:
    QTextStream m_textStream;
 
+   QBuffer  m_buffer;
    QFile    m_file;
    QString  m_fileName;
    QString  m_dir;
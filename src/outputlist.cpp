@@ -119,16 +119,13 @@ bool OutputList::generateDoc(const QString &fileName, int startLine, QSharedPoin
       return true;   // no output formats enabled
    }
 
-   DocRoot *root = nullptr;
-   root = validatingParseDoc(fileName, startLine, ctx, md, docStr, indexWords, isExample,
+   // the same block is often written to several pages, the tree is shared
+   QSharedPointer<DocRoot> root = cachedParseDoc(fileName, startLine, ctx, md, docStr, indexWords, isExample,
                   exampleName, singleLine, linkFromIndex);
 
-   writeDoc(root, ctx, md);
+   writeDoc(root.data(), ctx, md);
 
-   bool isEmpty = root->isEmpty();
-   delete root;
-
-   return isEmpty;
+   return root->isEmpty();
 }
 
 void OutputList::writeDoc(DocRoot *root, QSharedPointer<Definition> ctx, QSharedPointer<MemberDef> md)
@@ -17,8 +17,16 @@
 *************************************************************************/
 
 #include <QByteArray>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
 #include <QHash>
+#include <QMutex>
+#include <QQueue>
 #include <QSet>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -60,7 +68,7 @@ class ClangParser::Private
 
    Private()
       : sources(nullptr), numFiles(0), numTokens(0), curLine(0), curToken(0),
-        tu(0), tokens(nullptr), cursors(nullptr), ufs(nullptr), detectedLang(Detected_Cpp)
+        index(nullptr), tu(0), tokens(nullptr), cursors(nullptr), ufs(nullptr), detectedLang(Detected_Cpp)
    {
    }
 
@@ -117,6 +125,10 @@ ClangParser::ClangParser()
 
 ClangParser::~ClangParser()
 {
+   if (p->index != nullptr) {
+      clang_disposeIndex(p->index);
+   }
+
    delete p;
 }
 
@@ -505,8 +517,49 @@ static bool documentKind(CXCursor cursor)
    return false;
 }
 
-// ** entry point
-void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStringList &includeFiles, QSharedPointer<Entry> root)
+// returns the name of the file used to save the translation unit, empty if clang-cache-dir is not set
+static QString translationUnitCacheFile(const std::vector<QString> &argList, CXUnsavedFile *ufs, uint numFiles)
+{
+   static QString cacheDir = [] () {
+      QString retval = Config::getString("clang-cache-dir");
+
+      if (! retval.isEmpty()) {
+
+         if (! QDir::isAbsolutePath(retval)) {
+            retval.prepend(Config::getString("output-dir") + "/");
+         }
+
+         if (! QDir().mkpath(retval)) {
+            warn_uncond("Unable to create clang cache directory %s\n", csPrintable(retval));
+            retval = QString();
+         }
+      }
+
+      return retval;
+   } ();
+
+   if (cacheDir.isEmpty()) {
+      return QString();
+   }
+
+   QCryptographicHash hash(QCryptographicHash::Md5);
+
+   for (const auto &item : argList) {
+      hash.addData(item.toUtf8());
+      hash.addData("\n", 1);
+   }
+
+   for (uint i = 0; i < numFiles; ++i) {
+      hash.addData(ufs[i].Filename, qstrlen(ufs[i].Filename) + 1);
+      hash.addData(ufs[i].Contents, ufs[i].Length);
+   }
+
+   return cacheDir + "/" + QString::fromLatin1(hash.result().toHex()) + ".ast";
+}
+
+// returns the arguments passed to clang for fileName, detectedLang is updated when the file
+// indicates a different language
+static std::vector<QString> clangArguments(const QString &fileName, ClangParser::Private::DetectedLang &detectedLang)
 {
    static QStringList const includePath          = Config::getList("include-path");
    static QStringList const preDefinedMacros     = Config::getList("predefined-macros");
@@ -667,27 +720,27 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
 
    SrcLangExt lang = getLanguageFromFileName(fileName);
 
-   if (lang == SrcLangExt_ObjC || p->detectedLang != ClangParser::Private::Detected_Cpp) {
+   if (lang == SrcLangExt_ObjC || detectedLang != ClangParser::Private::Detected_Cpp) {
       QFileInfo fi(fileName);
       QString ext = fi.suffix().toLower();
 
-      if (p->detectedLang == ClangParser::Private::Detected_Cpp &&
+      if (detectedLang == ClangParser::Private::Detected_Cpp &&
             (ext == "cpp" || ext == "cxx" || ext == "cc" || ext == "c")) {
 
          // fall back to C/C++ once we see an extension that indicates C++
-         p->detectedLang = ClangParser::Private::Detected_Cpp;
+         detectedLang = ClangParser::Private::Detected_Cpp;
 
       } else if (ext == "mm") {
          // switch to Objective C++
-         p->detectedLang = ClangParser::Private::Detected_ObjCpp;
+         detectedLang = ClangParser::Private::Detected_ObjCpp;
 
       } else if (ext == "m") {
          // switch to Objective C
-         p->detectedLang = ClangParser::Private::Detected_ObjC;
+         detectedLang = ClangParser::Private::Detected_ObjC;
       }
    }
 
-   switch (p->detectedLang) {
+   switch (detectedLang) {
       case ClangParser::Private::Detected_Cpp:
          argList.push_back("c++");
          break;
@@ -704,8 +757,465 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
    // file name added
    argList.push_back(fileName);
 
+   return argList;
+}
+
+// parses a translation unit, when clang-cache-dir is set a translation unit saved by a previous pass or
+// a previous run is loaded if the arguments and the contents of all files are the same
+static CXErrorCode parseTranslationUnit(CXIndex index, const std::vector<QString> &argList, CXUnsavedFile *ufs,
+                  uint numUnsavedFiles, const QString &cacheFile, CXTranslationUnit *tu)
+{
+   // copy data to a usable vector for clang
+   std::vector<const char *> argv;
+   for (auto &item : argList) {
+      argv.push_back(item.constData());
+   }
+
+   int argc = argList.size();
+
+   // passed data - index, 0, command line args, number of args, included files
+   // num of unsaved files, clang flag indicating full preprocessing, translation unit structure
+
+   CXErrorCode errorCode = CXError_Failure;
+
+   if (! cacheFile.isEmpty() && QFile::exists(cacheFile)) {
+      errorCode = clang_createTranslationUnit2(index, cacheFile.toUtf8().constData(), tu);
+
+      if (errorCode != CXError_Success) {
+         *tu = 0;
+      }
+   }
+
+   if (errorCode != CXError_Success) {
+      uint options = CXTranslationUnit_DetailedPreprocessingRecord;
+
+      if (! cacheFile.isEmpty()) {
+         options |= CXTranslationUnit_ForSerialization;
+      }
+
+      errorCode = clang_parseTranslationUnit2(index, 0, &argv[0], argc, ufs, numUnsavedFiles, options, tu);
+
+      if (errorCode == CXError_Success && ! cacheFile.isEmpty()) {
+         // rename so a partially written file is never loaded
+         QString tmpFile = cacheFile + ".tmp";
+
+         if (clang_saveTranslationUnit(*tu, tmpFile.toUtf8().constData(), clang_defaultSaveOptions(*tu)) == CXSaveError_None) {
+            QFile::remove(cacheFile);
+            QFile::rename(tmpFile, cacheFile);
+
+         } else {
+            QFile::remove(tmpFile);
+
+         }
+      }
+   }
+
+   return errorCode;
+}
+
+/** Parses translation units on worker threads, each thread has its own CXIndex. The translation units
+ *  are saved in clang-cache-dir and loaded by ClangParser::start(). The libTooling pass and the handling
+ *  of the comments use global state and still run on the main thread.
+ */
+class ClangPrefetchQueue
+{
+ public:
+   static ClangPrefetchQueue *instance();
+
+   bool isEnabled() const;
+
+   void enqueue(const std::vector<QString> &argList, const QStringList &fileNames, const QVector<QByteArray> &sources);
+
+   // wait until a worker is done with the given translation unit, a queued job is removed
+   void waitFor(const QString &cacheFile);
+
+   // finish running jobs, discard queued jobs and stop the worker threads
+   void stop();
+
+ private:
+   struct Job {
+      std::vector<QString> argList;
+      QStringList          fileNames;
+      QVector<QByteArray>  sources;
+      QString              cacheFile;
+   };
+
+   ClangPrefetchQueue();
+
+   bool nextJob(Job &job);
+   void jobDone(const QString &cacheFile);
+   void runJobs();
+
+   QQueue<Job>     m_jobs;
+   QSet<QString>   m_pending;
+   QList<QThread *> m_workers;
+
+   bool m_stop;
+
+   QWaitCondition  m_jobReady;
+   QWaitCondition  m_jobDone;
+   QMutex          m_mutex;
+
+   friend class ClangPrefetchThread;
+};
+
+class ClangPrefetchThread : public QThread
+{
+ public:
+   ClangPrefetchThread(ClangPrefetchQueue *queue)
+      : m_queue(queue)
+   { }
+
+   void run() override {
+      m_queue->runJobs();
+   }
+
+ private:
+   ClangPrefetchQueue *m_queue;
+};
+
+ClangPrefetchQueue::ClangPrefetchQueue()
+   : m_stop(false)
+{
+}
+
+ClangPrefetchQueue *ClangPrefetchQueue::instance()
+{
+   static ClangPrefetchQueue retval;
+   return &retval;
+}
+
+bool ClangPrefetchQueue::isEnabled() const
+{
+   static const int numThreads = Config::getInt("parse-num-threads");
+   static const bool useCache  = ! Config::getString("clang-cache-dir").isEmpty();
+
+   return useCache && numThreads != 1;
+}
+
+// builds the array of in memory files passed to clang, names holds the data for the file names
+static QVector<CXUnsavedFile> unsavedFiles(const QStringList &fileNames, const QVector<QByteArray> &sources,
+                  QVector<QByteArray> &names)
+{
+   QVector<CXUnsavedFile> retval(fileNames.count());
+
+   for (int i = 0; i < fileNames.count(); ++i) {
+      names.append(fileNames[i].toUtf8());
+   }
+
+   for (int i = 0; i < fileNames.count(); ++i) {
+      retval[i].Filename = names[i].constData();
+      retval[i].Contents = sources[i].constData();
+      retval[i].Length   = sources[i].length();
+   }
+
+   return retval;
+}
+
+void ClangPrefetchQueue::enqueue(const std::vector<QString> &argList, const QStringList &fileNames,
+                  const QVector<QByteArray> &sources)
+{
+   Job job;
+
+   job.argList   = argList;
+   job.fileNames = fileNames;
+   job.sources   = sources;
+
+   QVector<QByteArray> names;
+   QVector<CXUnsavedFile> ufs = unsavedFiles(fileNames, sources, names);
+
+   job.cacheFile = translationUnitCacheFile(argList, ufs.data(), ufs.count());
+
+   if (job.cacheFile.isEmpty() || QFile::exists(job.cacheFile)) {
+      // saved by a previous run
+      return;
+   }
+
+   QMutexLocker locker(&m_mutex);
+
+   if (m_pending.contains(job.cacheFile)) {
+      return;
+   }
+
+   if (m_workers.isEmpty()) {
+      int numThreads = Config::getInt("parse-num-threads");
+
+      if (numThreads == 0) {
+         numThreads = qMax(2, QThread::idealThreadCount());
+      }
+
+      numThreads = qMin(numThreads, 32);
+
+      for (int i = 0; i < numThreads; ++i) {
+         QThread *thread = new ClangPrefetchThread(this);
+         thread->start();
+
+         if (thread->isRunning()) {
+            m_workers.append(thread);
+         } else {
+            // no more threads available
+            delete thread;
+         }
+      }
+   }
+
+   m_pending.insert(job.cacheFile);
+   m_jobs.enqueue(std::move(job));
+
+   m_jobReady.wakeOne();
+}
+
+void ClangPrefetchQueue::waitFor(const QString &cacheFile)
+{
+   if (cacheFile.isEmpty()) {
+      return;
+   }
+
+   QMutexLocker locker(&m_mutex);
+
+   for (int i = 0; i < m_jobs.count(); ++i) {
+      if (m_jobs[i].cacheFile == cacheFile) {
+         // not started yet, the caller will parse it
+         m_jobs.removeAt(i);
+         m_pending.remove(cacheFile);
+
+         return;
+      }
+   }
+
+   while (m_pending.contains(cacheFile)) {
+      m_jobDone.wait(&m_mutex);
+   }
+}
+
+void ClangPrefetchQueue::stop()
+{
+   {
+      QMutexLocker locker(&m_mutex);
+
+      for (const auto &job : m_jobs) {
+         m_pending.remove(job.cacheFile);
+      }
+
+      m_jobs.clear();
+
+      m_stop = true;
+      m_jobReady.wakeAll();
+   }
+
+   for (auto thread : m_workers) {
+      thread->wait();
+      delete thread;
+   }
+
+   m_workers.clear();
+   m_stop = false;
+}
+
+bool ClangPrefetchQueue::nextJob(Job &job)
+{
+   QMutexLocker locker(&m_mutex);
+
+   while (! m_stop && m_jobs.isEmpty()) {
+      m_jobReady.wait(&m_mutex);
+   }
+
+   if (m_jobs.isEmpty()) {
+      return false;
+   }
+
+   job = m_jobs.dequeue();
+
+   return true;
+}
+
+void ClangPrefetchQueue::jobDone(const QString &cacheFile)
+{
+   QMutexLocker locker(&m_mutex);
+
+   m_pending.remove(cacheFile);
+   m_jobDone.wakeAll();
+}
+
+void ClangPrefetchQueue::runJobs()
+{
    // exclude PCH files, disable diagnostics
-   p->index    = clang_createIndex(false, false);
+   CXIndex index = clang_createIndex(false, false);
+
+   Job job;
+
+   while (nextJob(job)) {
+      QVector<QByteArray> names;
+      QVector<CXUnsavedFile> ufs = unsavedFiles(job.fileNames, job.sources, names);
+
+      CXTranslationUnit tu = 0;
+
+      if (parseTranslationUnit(index, job.argList, ufs.data(), ufs.count(), job.cacheFile, &tu) == CXError_Success) {
+         clang_disposeTranslationUnit(tu);
+      }
+
+      jobDone(job.cacheFile);
+   }
+
+   clang_disposeIndex(index);
+}
+
+// token visited when the comments are added to the entries, comment is empty for any other token
+struct CommentWalkToken {
+   uint    index;
+   QString comment;
+};
+
+// returns the comments in the comment converted buffer, indexed by the line where each comment starts
+static QHash<uint, QStringList> convertedComments(const QString &buffer)
+{
+   QHash<uint, QStringList> retval;
+
+   uint line = 1;
+
+   QString::const_iterator iter = buffer.constBegin();
+   QString::const_iterator end  = buffer.constEnd();
+
+   while (iter != end) {
+      QChar c = *iter;
+
+      if (c == '\n') {
+         ++line;
+         ++iter;
+
+      } else if (c.isDigit()) {
+         // skip numbers, a ' between digits is a digit separator
+         ++iter;
+
+         while (iter != end) {
+            QChar next = *iter;
+
+            if (next.isLetterOrNumber() || next == '.' || next == '_') {
+               ++iter;
+
+            } else if (next == '\'' && iter + 1 != end && (*(iter + 1)).isLetterOrNumber()) {
+               ++iter;
+
+            } else {
+               break;
+            }
+         }
+
+      } else if (c.isLetter() || c == '_') {
+         // skip identifiers, the prefix of a character literal is part of the identifier
+         QString::const_iterator start = iter;
+
+         while (iter != end && ((*iter).isLetterOrNumber() || *iter == '_')) {
+            ++iter;
+         }
+
+         QString prefix(start, iter);
+
+         if (iter != end && *iter == '"' && (prefix == "R" || prefix == "LR" || prefix == "uR" ||
+                  prefix == "UR" || prefix == "u8R")) {
+
+            // skip a raw string, R"delim( ... )delim"
+            QString delimiter;
+            ++iter;
+
+            while (iter != end && *iter != '(' && *iter != '\n') {
+               delimiter.append(*iter);
+               ++iter;
+            }
+
+            if (iter == end || *iter != '(') {
+               // not a raw string
+               continue;
+            }
+
+            const QString terminator = ")" + delimiter + "\"";
+            QString tail;
+
+            while (iter != end) {
+
+               if (*iter == '\n') {
+                  ++line;
+               }
+
+               tail.append(*iter);
+               ++iter;
+
+               if (tail.endsWith(terminator)) {
+                  break;
+               }
+            }
+         }
+
+      } else if (c == '"' || c == '\'') {
+         // skip string and character literals
+         ++iter;
+
+         while (iter != end && *iter != c && *iter != '\n') {
+
+            if (*iter == '\\') {
+               ++iter;
+
+               if (iter == end) {
+                  break;
+
+               } else if (*iter == '\n') {
+                  ++line;
+               }
+            }
+
+            ++iter;
+         }
+
+         if (iter != end && *iter == c) {
+            ++iter;
+         }
+
+      } else if (c == '/' && iter + 1 != end && (*(iter + 1) == '/' || *(iter + 1) == '*')) {
+         QString::const_iterator start = iter;
+         uint startLine = line;
+
+         if (*(iter + 1) == '/') {
+            while (iter != end && *iter != '\n') {
+               ++iter;
+            }
+
+         } else {
+            iter = iter + 2;
+
+            while (iter != end) {
+
+               if (*iter == '*' && iter + 1 != end && *(iter + 1) == '/') {
+                  iter = iter + 2;
+                  break;
+
+               } else if (*iter == '\n') {
+                  ++line;
+               }
+
+               ++iter;
+            }
+         }
+
+         retval[startLine].append(QString(start, iter));
+
+      } else {
+         ++iter;
+
+      }
+   }
+
+   return retval;
+}
+
+// ** entry point
+void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStringList &includeFiles, QSharedPointer<Entry> root)
+{
+   std::vector<QString> argList = clangArguments(fileName, p->detectedLang);
+
+   // exclude PCH files, disable diagnostics, the index is shared by all translation units
+   if (p->index == nullptr) {
+      p->index = clang_createIndex(false, false);
+   }
 
    p->fileName = fileName;
    p->curLine  = 1;
@@ -720,12 +1230,9 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
    p->sources  = new QByteArray[numUnsavedFiles];
    p->ufs      = new CXUnsavedFile[numUnsavedFiles];
 
-   // load main file
-   if (fileBuffer.isEmpty()) {
-      p->sources[0]   = detab(fileToString(fileName, filterSourceFiles, true)).toUtf8();
-   } else  {
-      p->sources[0]   = fileBuffer.toUtf8();
-   }
+   // load main file, both passes pass the same contents to clang so the translation unit saved by
+   // the first pass is reused, the comment converted fileBuffer is only used for the comments
+   p->sources[0]      = detab(fileToString(fileName, filterSourceFiles, true)).toUtf8();
 
    p->ufs[0].Filename = strdup(fileName.toUtf8().constData());
    p->ufs[0].Contents = p->sources[0].constData();
@@ -745,20 +1252,13 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
       i++;
    }
 
-   // copy data to a usable vector for clang
-   std::vector<const char *> argv;
-   for (auto &item : argList) {
-      argv.push_back(item.constData());
-   }
+   // libClang - used to set up the tokens for comments
+   QString cacheFile = translationUnitCacheFile(argList, p->ufs, numUnsavedFiles);
 
-   int argc = argList.size();
+   // a worker thread may be parsing the same translation unit
+   ClangPrefetchQueue::instance()->waitFor(cacheFile);
 
-   // passed data - index, 0, command line args, number of args, included files
-   // num of unsaved files, clang flag indicating full preprocessing, translation unit structure
-
-   // libClang - used to set up the tokens for comments
-   CXErrorCode errorCode = clang_parseTranslationUnit2(p->index, 0, &argv[0], argc, p->ufs, numUnsavedFiles,
-                  CXTranslationUnit_DetailedPreprocessingRecord, &(p->tu) );
+   CXErrorCode errorCode = parseTranslationUnit(p->index, argList, p->ufs, numUnsavedFiles, cacheFile, &(p->tu));
 
    if (p->tu) {
       // filter out any includes not found by the clang parser
@@ -823,6 +1323,9 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
             int result = tool.run(clang::tooling::newFrontendActionFactory<DoxyFrontEnd>().get());
 */
 
+         } else if (! cacheFile.isEmpty() && QFile::exists(cacheFile) && DoxyFrontEnd::parseASTFile(cacheFile)) {
+            // the translation unit saved by libClang was loaded, the source is not parsed a second time
+
          } else {
             // save argList in a different vector for libTooling
             std::vector<std::string> argTmp;
@@ -874,13 +1377,55 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
       static const bool javadoc_auto_brief = Config::getBool("javadoc-auto-brief");
       static const bool qt_auto_brief      = Config::getBool("qt-auto-brief");
 
-      // walk the tokens
-      for (int index = 0; index < p->numTokens; ++index)  {
+      // the comment converted buffer has the same line numbers as the source passed to clang
+      QHash<uint, QStringList> comments;
 
-         CXTokenKind tokenKind = clang_getTokenKind(p->tokens[index]);
+      if (! fileBuffer.isEmpty()) {
+         comments = convertedComments(fileBuffer);
+      }
 
-         if (tokenKind == CXToken_Comment) {
-            QString comment = getTokenSpelling(p->tu, p->tokens[index]).trimmed();
+      QVector<CommentWalkToken> walk;
+
+      uint lastCommentLine  = 0;
+      int  lineCommentIndex = 0;
+
+      for (uint index = 0; index < p->numTokens; ++index)  {
+
+         if (clang_getTokenKind(p->tokens[index]) != CXToken_Comment) {
+            walk.append(CommentWalkToken{index, QString()});
+
+         } else if (fileBuffer.isEmpty()) {
+            walk.append(CommentWalkToken{index, getTokenSpelling(p->tu, p->tokens[index])});
+
+         } else {
+            uint line;
+            CXSourceLocation start = clang_getTokenLocation(p->tu, p->tokens[index]);
+            clang_getSpellingLocation(start, 0, &line, 0, 0);
+
+            if (line != lastCommentLine) {
+               lastCommentLine  = line;
+               lineCommentIndex = 0;
+            }
+
+            // the n-th comment starting on a line of the converted buffer belongs to the n-th comment
+            // token on the same line, comments merged by the conversion only start on the first line
+            const QStringList lineComments = comments.value(line);
+
+            if (lineCommentIndex < lineComments.count()) {
+               walk.append(CommentWalkToken{index, lineComments[lineCommentIndex]});
+            }
+
+            ++lineCommentIndex;
+         }
+      }
+
+      const int numTokens = walk.count();
+
+      // walk the tokens
+      for (int index = 0; index < numTokens; ++index)  {
+
+         if (! walk[index].comment.isEmpty()) {
+            QString comment = walk[index].comment.trimmed();
 
             CXCursor cursor;
             bool isBrief = false;
@@ -894,14 +1439,14 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
                int tmpIndex = index - 1;
 
                while (tmpIndex >= 0)   {
-                  cursor = p->cursors[tmpIndex];
+                  cursor = p->cursors[walk[tmpIndex].index];
                   bool found = true;
 
                   if (clang_Cursor_isNull(cursor) || ! documentKind(cursor)) {
                      found = false;
 
                   } else {
-                     QString phrase = getTokenSpelling(p->tu, p->tokens[tmpIndex]);
+                     QString phrase = getTokenSpelling(p->tu, p->tokens[walk[tmpIndex].index]);
 
                      if (phrase == "," || phrase == ";") {
                         found = false;
@@ -950,15 +1495,13 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
 
                ++index;
 
-               while (index < p->numTokens) {
+               while (index < numTokens) {
                   // skip over the cursor comment
-                  cursor = p->cursors[index];
-
-                  tokenKind = clang_getTokenKind(p->tokens[index]);
+                  cursor = p->cursors[walk[index].index];
 
-                  if (tokenKind == CXToken_Comment) {
+                  if (! walk[index].comment.isEmpty()) {
                      // next cursor is also a comment, merge
-                     QString extra = getTokenSpelling(p->tu, p->tokens[index]).trimmed();
+                     QString extra = walk[index].comment.trimmed();
 
                      int len = extra.length() - 5;
                      extra = extra.mid(3, len);
@@ -973,8 +1516,8 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
                    ++index;
                }
 
-               while (index < p->numTokens && ! documentKind(cursor) ) {
-                  cursor = p->cursors[++index];
+               while (index + 1 < numTokens && ! documentKind(cursor) ) {
+                  cursor = p->cursors[walk[++index].index];
                }
 
                // remove single *
@@ -993,15 +1536,13 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
 
                ++index;
 
-               while (index < p->numTokens) {
+               while (index < numTokens) {
                   // skip over the cursor comment
-                  cursor = p->cursors[index];
+                  cursor = p->cursors[walk[index].index];
 
-                  tokenKind = clang_getTokenKind(p->tokens[index]);
-
-                  if (tokenKind == CXToken_Comment) {
+                  if (! walk[index].comment.isEmpty()) {
                      // next cursor is also a comment, merge
-                     QString extra = getTokenSpelling(p->tu, p->tokens[index]).trimmed();
+                     QString extra = walk[index].comment.trimmed();
 
                      int len = extra.length() - 5;
                      extra   = extra.mid(3, len);
@@ -1016,8 +1557,8 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
                    ++index;
                }
 
-               while (index < p->numTokens && ! documentKind(cursor) ) {
-                  cursor = p->cursors[++index];
+               while (index + 1 < numTokens && ! documentKind(cursor) ) {
+                  cursor = p->cursors[walk[++index].index];
                }
 
                if (qt_auto_brief) {
@@ -1032,15 +1573,13 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
 
                int tmpIndex = index + 1;
 
-               while (tmpIndex < p->numTokens)  {
+               while (tmpIndex < numTokens)  {
                   // is the next cursor a comment?
-                  CXTokenKind tokenKind = clang_getTokenKind(p->tokens[tmpIndex]);
-
-                  if (tokenKind == CXToken_Comment) {
+                  if (! walk[tmpIndex].comment.isEmpty()) {
                      tmpIndex++;
 
                   }  else {
-                     cursor = p->cursors[tmpIndex];
+                     cursor = p->cursors[walk[tmpIndex].index];
 
                      if (getCursorUSR(cursor).isEmpty()) {
                         tmpIndex++;
@@ -1110,6 +1649,38 @@ printf("\n   Heads Up - libClang is NOT happy  %d\n\n", errorCode);
    }
 }
 
+bool ClangParser::canPrefetch() const
+{
+   return ClangPrefetchQueue::instance()->isEnabled();
+}
+
+void ClangParser::prefetch(const QString &fileName, const QStringList &includeFiles)
+{
+   static const bool filterSourceFiles = Config::getBool("filter-source-files");
+
+   // files parsed later must not change the language detected for the current file
+   ClangParser::Private::DetectedLang detectedLang = p->detectedLang;
+   std::vector<QString> argList = clangArguments(fileName, detectedLang);
+
+   QStringList fileNames;
+   QVector<QByteArray> sources;
+
+   fileNames.append(fileName);
+   sources.append(detab(fileToString(fileName, filterSourceFiles, true)).toUtf8());
+
+   for (const auto &item : includeFiles) {
+      fileNames.append(item);
+      sources.append(detab(fileToString(item, filterSourceFiles, true)).toUtf8());
+   }
+
+   ClangPrefetchQueue::instance()->enqueue(argList, fileNames, sources);
+}
+
+void ClangParser::finishPrefetch()
+{
+   ClangPrefetchQueue::instance()->stop();
+}
+
 void ClangParser::finish()
 {
    if (p->tu) {
@@ -1118,7 +1689,6 @@ void ClangParser::finish()
 
       clang_disposeTokens(p->tu, p->tokens, p->numTokens);
       clang_disposeTranslationUnit(p->tu);
-      clang_disposeIndex(p->index);
 
       p->fileMapping.clear();
       p->tokens    = 0;
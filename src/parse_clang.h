@@ -44,6 +44,15 @@ class ClangParser
    // clean up, free resources used in parsing
    void finish();
 
+   // true if translation units can be parsed on worker threads, requires clang-cache-dir
+   bool canPrefetch() const;
+
+   // parse the translation unit for a later call to start() on a worker thread, same files as start()
+   void prefetch(const QString &fileName, const QStringList &includeFiles);
+
+   // wait for the worker threads and stop them
+   void finishPrefetch();
+
    // looks for a symbol which should be found at line, returns a clang unique ref to the symbol
    QString lookup(uint line, const QString &symbol);
 
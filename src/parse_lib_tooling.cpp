@@ -1236,3 +1236,36 @@ class DoxyASTConsumer : public clang::ASTConsumer {
 std::unique_ptr<clang::ASTConsumer> DoxyFrontEnd::CreateASTConsumer(clang::CompilerInstance &compiler, llvm::StringRef file) {
    return std::unique_ptr<clang::ASTConsumer>(new DoxyASTConsumer(&compiler.getASTContext()));
 }
+
+bool DoxyFrontEnd::parseASTFile(const QString &astFile)
+{
+   const std::string stdFName = astFile.constData();
+
+   auto pchOperations = std::make_shared<clang::PCHContainerOperations>();
+
+   // diagnostics were already shown when libClang parsed the source
+   llvm::IntrusiveRefCntPtr<clang::DiagnosticsEngine> diags = clang::CompilerInstance::createDiagnostics(
+         new clang::DiagnosticOptions(), new clang::IgnoringDiagConsumer());
+
+   // the arguments of LoadFromASTFile changed in clang 10 and clang 18, a translation unit with
+   // errors is only loaded by clang versions where the settings libClang uses can be passed
+#if CLANG_VERSION_MAJOR < 10
+   std::unique_ptr<clang::ASTUnit> unit = clang::ASTUnit::LoadFromASTFile(stdFName, pchOperations->getRawReader(),
+         clang::ASTUnit::LoadEverything, diags, clang::FileSystemOptions(), false, false, llvm::None, true, true, true);
+#elif CLANG_VERSION_MAJOR < 18
+   std::unique_ptr<clang::ASTUnit> unit = clang::ASTUnit::LoadFromASTFile(stdFName, pchOperations->getRawReader(),
+         clang::ASTUnit::LoadEverything, diags, clang::FileSystemOptions());
+#else
+   std::unique_ptr<clang::ASTUnit> unit = clang::ASTUnit::LoadFromASTFile(stdFName, pchOperations->getRawReader(),
+         clang::ASTUnit::LoadEverything, diags, clang::FileSystemOptions(), std::make_shared<clang::HeaderSearchOptions>());
+#endif
+
+   if (unit == nullptr) {
+      return false;
+   }
+
+   DoxyASTConsumer consumer(&unit->getASTContext());
+   consumer.HandleTranslationUnit(unit->getASTContext());
+
+   return true;
+}
@@ -25,6 +25,8 @@
 
 #include <clang/AST/ASTConsumer.h>
 #include <clang/AST/RecursiveASTVisitor.h>
+#include <clang/Basic/Version.h>
+#include <clang/Frontend/ASTUnit.h>
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Frontend/FrontendActions.h>
 #include <clang/Index/USRGeneration.h>
@@ -39,6 +41,9 @@ class DoxyFrontEnd : public clang::ASTFrontendAction
 {
    public:
       std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance &compiler, llvm::StringRef file) override;
+
+      // adds the entries for a translation unit saved by libClang, returns false if the file can not be loaded
+      static bool parseASTFile(const QString &astFile);
 };
 
 #endif
\ No newline at end of file
@@ -1651,7 +1651,7 @@ static void addPerlModDocBlock(PerlModOutput &output, const QString &name, const
 
    } else {
 
-      DocNode *root = validatingParseDoc(fileName, lineNr, scope, md, stext, false, false);
+      QSharedPointer<DocRoot> root = cachedParseDoc(fileName, lineNr, scope, md, stext, false, false);
       output.openHash(name);
 
       PerlModDocVisitor *visitor = new PerlModDocVisitor(output);
@@ -1660,7 +1660,6 @@ static void addPerlModDocBlock(PerlModOutput &output, const QString &name, const
       output.closeHash();
 
       delete visitor;
-      delete root;
    }
 }
 
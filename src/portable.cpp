@@ -30,13 +30,20 @@
 #define _WIN32_DCOM
 #include <windows.h>
 
+#define PSAPI_VERSION 2
+#include <psapi.h>
+
+#include <sys/utime.h>
+
 #else
 
 #include <unistd.h>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <errno.h>
+#include <utime.h>
 
 extern char **environ;
 
@@ -392,3 +399,92 @@ void portable_sleep(int ms)
 #endif
 }
 
+// returns the processor time used by this process in seconds, all threads are included
+double portable_getCpuTime()
+{
+#ifdef HAVE_WINDOWS_H
+   FILETIME createTime;
+   FILETIME exitTime;
+   FILETIME kernelTime;
+   FILETIME userTime;
+
+   if (! GetProcessTimes(GetCurrentProcess(), &createTime, &exitTime, &kernelTime, &userTime)) {
+      return 0.0;
+   }
+
+   ULARGE_INTEGER kernel;
+   kernel.LowPart  = kernelTime.dwLowDateTime;
+   kernel.HighPart = kernelTime.dwHighDateTime;
+
+   ULARGE_INTEGER user;
+   user.LowPart  = userTime.dwLowDateTime;
+   user.HighPart = userTime.dwHighDateTime;
+
+   // values are in units of 100 nanoseconds
+   return (kernel.QuadPart + user.QuadPart) / 10000000.0;
+
+#else
+   struct rusage usage;
+
+   if (getrusage(RUSAGE_SELF, &usage) != 0) {
+      return 0.0;
+   }
+
+   return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+#endif
+}
+
+// returns the peak resident set size of this process in bytes
+qint64 portable_getPeakMemory()
+{
+#ifdef HAVE_WINDOWS_H
+   PROCESS_MEMORY_COUNTERS counters;
+
+   if (! GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+      return 0;
+   }
+
+   return counters.PeakWorkingSetSize;
+
+#else
+   struct rusage usage;
+
+   if (getrusage(RUSAGE_SELF, &usage) != 0) {
+      return 0;
+   }
+
+#if defined(__APPLE__)
+   // reported in bytes
+   return usage.ru_maxrss;
+#else
+   // reported in kilobytes
+   return qint64(usage.ru_maxrss) * 1024;
+#endif
+
+#endif
+}
+
+// creates target as a hard link to source, returns false if the file system does not support it
+bool portable_linkFile(const QString &source, const QString &target)
+{
+#ifdef HAVE_WINDOWS_H
+   std::wstring sourceName = source.toStdWString();
+   std::wstring targetName = target.toStdWString();
+
+   return CreateHardLinkW(targetName.c_str(), sourceName.c_str(), nullptr) != 0;
+#else
+   return link(source.toUtf8().constData(), target.toUtf8().constData()) == 0;
+#endif
+}
+
+// sets the modification time of the file to the current time
+void portable_touchFile(const QString &fileName)
+{
+#ifdef HAVE_WINDOWS_H
+   std::wstring name = fileName.toStdWString();
+   _wutime(name.c_str(), nullptr);
+#else
+   utime(fileName.toUtf8().constData(), nullptr);
+#endif
+}
@@ -52,5 +52,11 @@ void           portable_sysTimerStop();
 double         portable_getSysElapsedTime();
 void           portable_sleep(int ms);
 
+double         portable_getCpuTime();
+qint64         portable_getPeakMemory();
+
+bool           portable_linkFile(const QString &source, const QString &target);
+void           portable_touchFile(const QString &fileName);
+
 #endif
 
@@ -16,12 +16,16 @@
 *
 *************************************************************************/
 
+#include <QElapsedTimer>
 #include <QFile>
+#include <QFileInfo>
 #include <QRegularExpression>
 #include <QTextStream>
 
+#include <algorithm>
 #include <ctype.h>
 #include <assert.h>
+#include <string.h>
 
 #include <searchindex.h>
 
@@ -31,30 +35,17 @@
 #include <language.h>
 #include <message.h>
 #include <resourcemgr.h>
+#include <searchmap.h>
 #include <util.h>
 
-IndexWord::IndexWord(const QString &word) : m_word(word)
+SearchIndex::SearchIndex()
+   : SearchIndex_Base(Internal), m_wordTable(1024, -1), m_wordsAdded(0), m_wordsSampled(0), m_addWordTime(0), m_urlIndex(-1)
 {
-}
-
-void IndexWord::addUrlIndex(int idx, bool hiPriority)
-{
-   QSharedPointer<URLInfo> ui = m_urls.value(idx);
-
-   if (! ui) {
-      ui = QMakeShared<URLInfo>(idx, 0);
-      m_urls.insert(idx, ui);
-   }
-
-   ui->freq += 2;
+   // reserved so the buffers keep their memory when they are resized to zero
+   m_wordBuffer.reserve(128);
+   m_wordParts.reserve(32);
 
-   if (hiPriority) {
-      ui->freq |= 1;   // mark as high priority document
-   }
-}
-
-SearchIndex::SearchIndex() : SearchIndex_Base(Internal), m_urlIndex(-1)
-{
+   m_timer.start();
 }
 
 SearchIndex::~SearchIndex()
@@ -181,74 +172,203 @@ static int charsToIndex(const QString &word)
    return c1 * 256 + c2;
 }
 
-void SearchIndex::addWord(const QString &word, bool hiPriority, bool recurse)
+static uint hashWord(const char *word, int length)
+{
+   // FNV-1a
+   uint retval = 2166136261u;
+
+   for (int i = 0; i < length; ++i) {
+      retval = (retval ^ uchar(word[i])) * 16777619u;
+   }
+
+   return retval;
+}
+
+static bool isCamelCaseBoundary(uint prev, uint c)
 {
-   if (word.isEmpty()) {
+   return (c >= 'A' && c <= 'Z') && (prev == '_' || prev == ':' || (prev >= 'a' && prev <= 'z'));
+}
+
+void SearchIndex::addWord(const QString &word, bool hiPriority)
+{
+   if (word.isEmpty() || m_urlIndex < 0) {
+      // words found before the first document are not indexed
       return;
    }
 
-   static QRegularExpression nextPart("[_a-z:][A-Z]");
+   // only every 64th word is timed, reading the clock costs about as much as indexing a short word
+   const bool sampled = (m_wordsAdded & 63) == 0;
+   qint64 startTime   = sampled ? m_timer.nsecsElapsed() : 0;
+
+   // a matching ignore-prefix is stripped, counted in characters
+   int prefix       = getPrefixIndex(word);
+   int prefixOffset = 0;
+
+   // lower case the word once, each part is a suffix of the buffer, m_wordParts holds the
+   // byte offset and the character position of every upper case letter starting a camel case part
+   m_wordBuffer.resize(0);
+   m_wordParts.resize(0);
 
-   QString wStr = word.toLower();
-   QSharedPointer<IndexWord> w = m_words.value(wStr);
+   uint prev  = 0;
+   int length = 0;
 
-   if (! w) {
-      int idx = charsToIndex(wStr);
+   for (QChar c : word) {
+      uint ch = c.unicode();
 
-      if (idx < 0) {
-         return;
+      if (length == prefix) {
+         prefixOffset = m_wordBuffer.size();
       }
 
-      w = QMakeShared<IndexWord>(wStr);
-      m_words.insert(wStr, w);
+      if (isCamelCaseBoundary(prev, ch)) {
+         m_wordParts.append(m_wordBuffer.size());
+         m_wordParts.append(length);
+      }
+
+      if (ch < 128) {
+         m_wordBuffer.append(char(ch >= 'A' && ch <= 'Z' ? ch + ('a' - 'A') : ch));
+      } else {
+         m_wordBuffer.append(c.toLower().toUtf8());
+      }
+
+      prev = ch;
+      ++length;
+   }
+
+   if (length < 2) {
+      return;
    }
 
-   w->addUrlIndex(m_urlIndex, hiPriority);
+   const char *data = m_wordBuffer.constData();
+   const int size   = m_wordBuffer.size();
 
-   int i;
-   bool found = false;
+   addWordPart(data, size, hiPriority);
 
-   if (! recurse) {
-      // the first time we check if we can strip the prefix
-      QRegularExpressionMatch match = nextPart.match(word);
+   int start  = 0;
+   bool split = true;
 
-      if (match.hasMatch()) {
-         addWord(QString(match.capturedStart(), word.end()), hiPriority, true);
-         found = true;
+   if (prefix > 0) {
+      // the word without the prefix is split instead of the word
+      split = (length - prefix >= 2);
+
+      if (split) {
+         addWordPart(data + prefixOffset, size - prefixOffset, hiPriority);
+      }
+
+      start = prefix;
+   }
+
+   // split at the first camel case boundary which is not after the first character, then split
+   // the remaining part the same way
+   for (int i = 0; split && i < m_wordParts.count(); i += 2) {
+      int offset   = m_wordParts[i];
+      int position = m_wordParts[i + 1];
+
+      if (position <= start) {
+         // boundary inside the prefix
+         continue;
+      }
+
+      if (position - 1 == start || length - position < 2) {
+         break;
       }
+
+      addWordPart(data + offset, size - offset, hiPriority);
+      start = position;
+   }
+
+   if (sampled) {
+      m_addWordTime += m_timer.nsecsElapsed() - startTime;
+      ++m_wordsSampled;
    }
 
-   if (! found) {
-      // no prefix stripped
-      QRegularExpressionMatch match = nextPart.match(word);
+   ++m_wordsAdded;
+}
+
+void SearchIndex::addWordPart(const char *word, int length, bool hiPriority)
+{
+   if (m_words.count() * 2 >= m_wordTable.count()) {
+      // keep the table at most half full
+      QVector<int> table(m_wordTable.count() * 2, -1);
+      uint mask = table.count() - 1;
 
-      if (match.hasMatch()) {
-         auto iter = match.capturedStart();
+      for (int i = 0; i < m_words.count(); ++i) {
+         uint slot = m_words[i].hash & mask;
 
-         if (iter != word.begin()) {
-            addWord(QString(iter + 1, word.end()), hiPriority, true);
+         while (table[slot] != -1) {
+            slot = (slot + 1) & mask;
          }
+
+         table[slot] = i;
+      }
+
+      m_wordTable = table;
+   }
+
+   uint hash = hashWord(word, length);
+   uint mask = m_wordTable.count() - 1;
+   uint slot = hash & mask;
+
+   int index;
+
+   while (true) {
+      index = m_wordTable[slot];
+
+      if (index == -1) {
+         IndexWord item;
+         item.word = QByteArray(word, length);
+         item.hash = hash;
+
+         index = m_words.count();
+         m_wordTable[slot] = index;
+         m_words.append(item);
+
+         break;
+      }
+
+      const IndexWord &item = m_words[index];
+
+      if (item.hash == hash && item.word.size() == length && memcmp(item.word.constData(), word, length) == 0) {
+         break;
       }
+
+      slot = (slot + 1) & mask;
+   }
+
+   QVector<SearchMap::Posting> &postings = m_words[index].postings;
+
+   // a document can be current more than once, the postings are merged in write()
+   if (postings.isEmpty() || postings.last().urlIdx != m_urlIndex) {
+      postings.append(SearchMap::Posting(m_urlIndex, 0));
+   }
+
+   SearchMap::Posting &posting = postings.last();
+   posting.freq += 2;
+
+   if (hiPriority) {
+      posting.freq |= 1;   // mark as high priority document
    }
 }
 
-void SearchIndex::addWord(const QString &word, bool hiPriority)
+static void appendInt(QByteArray &buffer, int value)
 {
-   addWord(word, hiPriority, false);
+   buffer.append(char(((uint)value) >> 24));
+   buffer.append(char((((uint)value) >> 16) & 0xff));
+   buffer.append(char((((uint)value) >> 8) & 0xff));
+   buffer.append(char(((uint)value) & 0xff));
 }
 
-static void writeInt(QFile &f, int index)
+static void setInt(QByteArray &buffer, int pos, int value)
 {
-   f.putChar(((uint)index) >> 24);
-   f.putChar((((uint)index) >> 16) & 0xff);
-   f.putChar((((uint)index) >> 8) & 0xff);
-   f.putChar(((uint)index) & 0xff);
+   buffer[pos]     = char(((uint)value) >> 24);
+   buffer[pos + 1] = char((((uint)value) >> 16) & 0xff);
+   buffer[pos + 2] = char((((uint)value) >> 8) & 0xff);
+   buffer[pos + 3] = char(((uint)value) & 0xff);
 }
 
-static void writeString(QFile &file, const QString &str)
+static void appendString(QByteArray &buffer, const QString &str)
 {
-   file.write(str.toUtf8());
-   file.putChar(0);
+   buffer.append(str.toUtf8());
+   buffer.append('\0');
 }
 
 
@@ -263,78 +383,177 @@ static void writeString(QFile &file, const QString &str)
 //                 (4 bytes index to url string + 4 bytes frequency counter)
 //   for each url: a \0 terminated string
 
+// merges the postings of a document which was made current again after other documents
+static void mergePostings(QVector<SearchMap::Posting> &postings)
+{
+   bool sorted = true;
+
+   for (int i = 1; i < postings.count(); ++i) {
+      if (postings[i - 1].urlIdx >= postings[i].urlIdx) {
+         sorted = false;
+         break;
+      }
+   }
+
+   if (sorted) {
+      return;
+   }
+
+   std::stable_sort(postings.begin(), postings.end(), [] (const SearchMap::Posting &a, const SearchMap::Posting &b) {
+      return a.urlIdx < b.urlIdx;
+   });
+
+   int count = 0;
+
+   for (int i = 0; i < postings.count(); ++i) {
+      if (count > 0 && postings[count - 1].urlIdx == postings[i].urlIdx) {
+         // add the occurrences, keep the high priority bit
+         SearchMap::Posting &posting = postings[count - 1];
+         posting.freq = ((posting.freq & ~1) + (postings[i].freq & ~1)) | ((posting.freq | postings[i].freq) & 1);
+
+      } else {
+         postings[count] = postings[i];
+         ++count;
+      }
+   }
+
+   postings.resize(count);
+}
+
 void SearchIndex::write(const QString &fileName)
+{
+   QElapsedTimer timer;
+   timer.start();
+
+   QVector<SearchMap::Word> words;
+   words.reserve(m_words.count());
+
+   for (const auto &item : m_words) {
+      SearchMap::Word word;
+      word.word     = item.word;
+      word.postings = item.postings;
+
+      mergePostings(word.postings);
+
+      words.append(word);
+   }
+
+   // search.idx groups the words by their first two characters
+   std::sort(words.begin(), words.end(), [] (const SearchMap::Word &a, const SearchMap::Word &b) {
+      return a.word < b.word;
+   });
+
+   QVector<SearchMap::Document> docs(m_urlIndex + 1);
+
+   for (auto iter = m_urls.begin(); iter != m_urls.end(); ++iter) {
+      docs[iter.key()].name = iter.value()->name;
+      docs[iter.key()].url  = iter.value()->url;
+   }
+
+   qint64 bufferSize = writeSearchIndex(fileName, words, docs);
+
+   if (bufferSize >= 0) {
+      // estimated from the timed words
+      double seconds = m_wordsSampled > 0 ? m_addWordTime / 1e9 * m_wordsAdded / m_wordsSampled : 0.0;
+
+      msg("Search index: %d words added in about %.1f ms, %.1f M words/s\n", m_wordsAdded, seconds * 1000.0,
+            seconds > 0 ? m_wordsAdded / seconds / 1e6 : 0.0);
+
+      msg("Search index: %d words, %d documents, %.1f MB buffer, written in %d ms\n", words.count(),
+            docs.count(), bufferSize / (1024.0 * 1024.0), int(timer.elapsed()));
+   }
+}
+
+qint64 writeSearchIndex(const QString &fileName, const QVector<SearchMap::Word> &words,
+                  const QVector<SearchMap::Document> &docs)
 {
    static const int numIndexEntries = 256 * 256;
 
-   QMap<QString, int> wordStatOffsets;
-   QMap<QString, int> urlOffsets;
-   QMap<int, int> wordOffsets;
+   // offsets are looked up by url id and by the position of the word
+   QVector<int> urlOffsets(docs.count(), 0);
+   QVector<int> wordStatOffsets;
+   wordStatOffsets.reserve(words.count());
 
-   QFile f(fileName);
+   // the whole file is built in memory and written at once
+   QByteArray buffer;
+   buffer.reserve(4 + (numIndexEntries * 4) + (words.count() * 32) + (docs.count() * 64));
 
-   if (f.open(QIODevice::WriteOnly)) {
-      // write header
-      f.putChar('D');
-      f.putChar('O');
-      f.putChar('X');
-      f.putChar('S');
+   // header, the index is filled in when the word lists are written
+   buffer.append("DOXS");
+   buffer.append(QByteArray(numIndexEntries * 4, '\0'));
+
+   // write urls
+   for (int i = 0; i < docs.count(); ++i) {
+      urlOffsets[i] = buffer.size();
 
-      f.seek((numIndexEntries * 4) + 4);
+      appendString(buffer, docs[i].name);
+      appendString(buffer, docs[i].url);
+   }
 
-      // write urls
-      for (auto item : m_urls) {
+   // write word statistics
+   for (const auto &item1 : words) {
+      wordStatOffsets.append(buffer.size());
 
-         // save the offset of this url
-         urlOffsets.insert(item->name, f.pos());
+      int numUrls = item1.postings.count();
+      appendInt(buffer, numUrls);
 
-         writeString(f, item->name);
-         writeString(f, item->url);
+      for (const auto &item2 : item1.postings) {
+         appendInt(buffer, item2.urlIdx < docs.count() ? urlOffsets[item2.urlIdx] : 0);
+         appendInt(buffer, item2.freq);
       }
+   }
+
+   int lastIndex = -1;
+   int wordIndex = 0;
 
-      // write word statistics
-      for (auto item1 : m_words) {
+   for (const auto &item : words) {
+      QString word     = QString::fromUtf8(item.word);
+      int currentIndex = charsToIndex(word);
 
-         // save the offset of this stats entry
-         wordStatOffsets.insert(item1->word(), f.pos() );
+      if (lastIndex != currentIndex) {
 
-         int numUrls = item1->urls().count();
-         writeInt(f, numUrls);
+         if (lastIndex != -1) {
+            buffer.append('\0');
+         }
+
+         lastIndex = currentIndex;
 
-         for (auto item2 : item1->urls() ) {
-            writeInt(f, urlOffsets.value(m_urls.value(item2->urlIdx)->name));
-            writeInt(f, item2->freq);
+         if (currentIndex >= 0 && currentIndex < numIndexEntries) {
+            setInt(buffer, 4 + (currentIndex * 4), buffer.size());
          }
       }
 
-      int lastIndex = -1;
+      appendString(buffer, word);
+      appendInt(buffer, wordStatOffsets[wordIndex]);
 
-      for (auto item : m_words) {
-         int currentIndex = charsToIndex(item->word());
+      ++wordIndex;
+   }
 
-         if (lastIndex != currentIndex) {
+   buffer.append('\0');
 
-            if (lastIndex != -1) {
-               f.putChar(0);
-            }
+   QFile f(fileName);
 
-            lastIndex = currentIndex;
-            wordOffsets.insert(currentIndex, f.pos());
-         }
+   if (! f.open(QIODevice::WriteOnly)) {
+      err("Unable to open file for writing %s, error: %d\n", csPrintable(fileName), f.error());
+      return -1;
+   }
 
-         writeString(f, item->word());
-         writeInt(f, wordStatOffsets[item->word()]);
-      }
+   if (f.write(buffer) != buffer.size()) {
+      err("Unable to write search index %s, error: %d\n", csPrintable(fileName), f.error());
+      return -1;
+   }
 
-      f.putChar(0);
+   f.close();
 
-      // write index
-      f.seek(4);
+   qint64 bufferSize = buffer.capacity();
+   buffer = QByteArray();
 
-      for (int i = 0; i < numIndexEntries; i++) {
-         writeInt(f, wordOffsets.value(i));
-      }
+   // memory mapped index, queried with the --s command line option and merged with --merge
+   if (! SearchMap::write(QFileInfo(fileName).absolutePath() + "/search.map", words, docs)) {
+      return -1;
    }
+
+   return bufferSize;
 }
 
 // the following part is for writing an external search index
@@ -659,6 +878,173 @@ static QString searchId(const QString &str)
    return result;
 }
 
+// url of the page for a search result without the anchor, relative to the search directory
+static QString searchFileUrl(QSharedPointer<Definition> d)
+{
+   return externalRef("../", d->getReference(), true) + d->getOutputFileBase() + Doxy_Globals::htmlFileExtension;
+}
+
+static bool searchTargetParent(QSharedPointer<Definition> d)
+{
+   static bool extLinksInWindow = Config::getBool("external-links-in-window");
+   return ! extLinksInWindow || d->getReference().isEmpty();
+}
+
+// scope shown for an item with a unique name
+static QString searchScope(QSharedPointer<Definition> d)
+{
+   QString retval;
+
+   if (d->getOuterScope() != Doxy_Globals::globalScope) {
+      retval = convertToXML(d->getOuterScope()->name());
+
+   } else if (d->definitionType() == Definition::TypeMember) {
+      QSharedPointer<MemberDef> md = d.dynamicCast<MemberDef>();
+      QSharedPointer<FileDef> fd   = md->getBodyDef();
+
+      if (fd == 0) {
+         fd = md->getFileDef();
+      }
+
+      if (fd) {
+         retval = convertToXML(fd->localName());
+      }
+   }
+
+   return retval;
+}
+
+// names shown for items which have the same name, overloaded functions show their arguments
+static QStringList searchChildNames(QSharedPointer<SearchDefinitionList> dl)
+{
+   QStringList retval;
+
+   QSharedPointer<Definition> next;
+   QSharedPointer<Definition> prevScope;
+
+   auto nextIter = dl->begin();
+
+   for (auto d : *dl)  {
+      QSharedPointer<Definition> scope = d->getOuterScope();
+
+      if (nextIter != dl->end()) {
+         ++nextIter;
+      }
+
+      if (nextIter == dl->end()) {
+         next = QSharedPointer<Definition>();
+
+      } else {
+         next = *nextIter;
+
+      }
+
+      QSharedPointer<Definition> nextScope;
+      QSharedPointer<MemberDef>  md;
+
+      bool isMemberDef = d->definitionType() == Definition::TypeMember;
+
+      if (isMemberDef) {
+         md = d.dynamicCast<MemberDef>();
+      }
+
+      if (next) {
+         nextScope = next->getOuterScope();
+      }
+
+      bool found = false;
+      bool overloadedFunction = ((prevScope != 0 && scope == prevScope) || (scope && scope == nextScope))
+                                && md && (md->isFunction() || md->isSlot());
+
+      QString prefix;
+
+      if (md) {
+         prefix = convertToXML(md->localName());
+      }
+
+      if (overloadedFunction) {
+         // overloaded member function
+         prefix += convertToXML(md->argsString());
+         // show argument list to disambiguate overloaded functions
+
+      } else if (md) {
+         // unique member function
+         prefix += "()"; // only to show it is a function
+      }
+
+      QString name;
+      if (d->definitionType() == Definition::TypeClass) {
+
+         name  = convertToXML(d.dynamicCast<ClassDef>()->displayName());
+         found = true;
+
+      } else if (d->definitionType() == Definition::TypeNamespace) {
+
+         name  = convertToXML(d.dynamicCast<NamespaceDef>()->displayName());
+         found = true;
+
+      } else if (scope == 0 || scope == Doxy_Globals::globalScope) {
+         // in global scope
+
+         if (md) {
+            QSharedPointer<FileDef> fd = md->getBodyDef();
+
+            if (fd == 0) {
+               fd = md->getFileDef();
+            }
+
+            if (fd) {
+               if (! prefix.isEmpty()) {
+                  prefix += ":&#160;";
+               }
+               name = prefix + convertToXML(fd->localName());
+               found = true;
+            }
+         }
+
+      } else if (md && (md->getClassDef() || md->getNamespaceDef())) {
+         // member in class or namespace scope
+
+         SrcLangExt lang = md->getLanguage();
+         name = convertToXML(d->getOuterScope()->qualifiedName())
+                + getLanguageSpecificSeparator(lang) + prefix;
+
+         found = true;
+
+      } else if (scope) {
+         // some thing else? -> show scope
+
+         name = prefix + convertToXML(scope->name());
+         found = true;
+      }
+
+      if (! found) {
+         // fallback
+         name = prefix + "(" + theTranslator->trGlobalNamespace() + ")";
+      }
+
+      retval.append(name);
+      prevScope = scope;
+   }
+
+   return retval;
+}
+
+static QString searchDisplayName(QSharedPointer<Definition> d)
+{
+   QString retval = d->localName();
+
+   if (d->definitionType() == Definition::TypeGroup) {
+      retval = d.dynamicCast<GroupDef>()->groupTitle();
+
+   } else if (d->definitionType() == Definition::TypePage) {
+      retval = d.dynamicCast<PageDef>()->title();
+
+   }
+
+   return retval;
+}
+
 static int g_searchIndexCount[NUM_SEARCH_INDICES];
 
 static LetterToIndexMap<SearchIndexMap> g_searchIndexSymbols[NUM_SEARCH_INDICES];
@@ -706,6 +1092,214 @@ class SearchIndexCategoryMapping
    QString categoryLabel[NUM_SEARCH_INDICES];
 };
 
+// name of the shard file holding the items whose display name starts with \a key
+// see also function searchShardFile() in search.js, which should match in behaviour
+static QString searchShardFile(const QString &key)
+{
+   QString retval = "shard";
+
+   for (auto c : key) {
+      retval += QString("_%1").formatArg(c.unicode(), 4, 16, QChar('0'));
+   }
+
+   return retval;
+}
+
+static QString searchJsString(const QString &str)
+{
+   QString retval = "'";
+
+   for (auto c : str) {
+
+      if (c.isLetterOrNumber() && c.unicode() < 128) {
+         retval += c;
+
+      } else {
+         retval += QString("\\u%1").formatArg(c.unicode(), 4, 16, QChar('0'));
+      }
+   }
+
+   retval += "'";
+
+   return retval;
+}
+
+/** Items of the compact search index which share the first two characters of their name */
+struct SearchShard {
+   int intern(const QString &str) {
+      auto iter = stringIds.find(str);
+
+      if (iter != stringIds.end()) {
+         return iter.value();
+      }
+
+      int retval = strings.count();
+
+      strings.append(str);
+      stringIds.insert(str, retval);
+
+      return retval;
+   }
+
+   QStringList strings;
+   QHash<QString, int> stringIds;
+
+   QString items;
+   int itemCount = 0;
+};
+
+// format of each shard file
+//   searchShard('<file name>', strings, items)
+//   strings[] = page urls, scopes and names used by the items of this shard
+//   items[x][0] = id
+//   items[x][1] = name as shown
+//   items[x][2] = array of definitions with this name
+//   items[x][2][y][0] = url of the page, index in strings
+//   items[x][2][y][1] = anchor
+//   items[x][2][y][2] = categories (bit n + 1 for index n), bit 0 set for target="_parent"
+//   items[x][2][y][3] = scope shown when this is the only match, index in strings
+//   items[x][2][y][4] = name shown when there are several matches, index in strings
+
+static void writeSearchShard(const QString &searchDirName, const QString &key, const SearchShard &shard, qint64 &bytesWritten)
+{
+   QString fileName = searchDirName + "/" + searchShardFile(key) + ".js";
+   QFile f(fileName);
+
+   if (! f.open(QIODevice::WriteOnly)) {
+      err("Unable to open file for writing %s, error: %d\n", csPrintable(fileName), f.error());
+      return;
+   }
+
+   QTextStream t(&f);
+
+   t << "searchShard('" << searchShardFile(key) << "',\n[";
+
+   bool first = true;
+
+   for (const auto &str : shard.strings) {
+      if (! first) {
+         t << ",";
+      }
+
+      t << "'" << str << "'";
+      first = false;
+   }
+
+   t << "],\n[\n" << shard.items << "\n]);\n";
+   t.flush();
+
+   bytesWritten += f.size();
+}
+
+// writes the items of the "all" index to shards, the categories are stored for each item
+static void writeCompactSearchIndex(const QString &searchDirName, QStringList &shardKeys)
+{
+   // categories of each definition
+   QHash<Definition *, int> categories;
+
+   for (int i = 0; i < NUM_SEARCH_INDICES; i++) {
+      for (auto sl : g_searchIndexSymbols[i]) {
+         for (auto dl : *sl) {
+            for (auto d : *dl) {
+               categories[d.data()] |= 1 << i;
+            }
+         }
+      }
+   }
+
+   int itemCount = 0;
+   qint64 bytesWritten = 0;
+
+   // the letter a symbol is listed under can differ from the first letter of its display name,
+   // std::chrono is listed under 's' and stored in shard "ch", so the shards are written at the end
+   QMap<QString, SearchShard> shards;
+
+   for (auto sl : g_searchIndexSymbols[SEARCH_INDEX_ALL]) {
+
+      for (auto dl : *sl) {
+         QSharedPointer<Definition> d = dl->first();
+         QString dispName = searchDisplayName(d);
+
+         SearchShard &shard = shards[dispName.left(2).toLower()];
+
+         if (shard.itemCount > 0) {
+            shard.items += ",\n";
+         }
+
+         shard.items += "['" + searchId(dispName) + "','" + convertToXML(dispName) + "',[";
+
+         QStringList names = searchChildNames(dl);
+         int childCount = 0;
+
+         for (auto child : *dl) {
+            int flags = (categories.value(child.data()) << 1) | (searchTargetParent(child) ? 1 : 0);
+
+            if (childCount > 0) {
+               shard.items += ",";
+            }
+
+            shard.items += QString("[%1,'%2',%3,%4,%5]").formatArg(shard.intern(searchFileUrl(child)))
+                  .formatArg(child->anchor()).formatArg(flags).formatArg(shard.intern(searchScope(child)))
+                  .formatArg(shard.intern(names[childCount]));
+
+            ++childCount;
+         }
+
+         shard.items += "]]";
+
+         ++shard.itemCount;
+         ++itemCount;
+      }
+   }
+
+   for (auto iter = shards.begin(); iter != shards.end(); ++iter) {
+      writeSearchShard(searchDirName, iter.key(), iter.value(), bytesWritten);
+      shardKeys.append(iter.key());
+   }
+
+   // page which shows the results, the shards are loaded by loadSearchShards()
+   QFile f(searchDirName + "/results.html");
+
+   if (f.open(QIODevice::WriteOnly)) {
+      QTextStream t(&f);
+
+      t << "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Transitional//EN\""
+        " \"http://www.w3.org/TR/xhtml1/DTD/xhtml1-transitional.dtd\">" << endl;
+      t << "<html><head><title></title>" << endl;
+      t << "<meta http-equiv=\"Content-Type\" content=\"text/xhtml;charset=UTF-8\"/>" << endl;
+      t << "<meta name=\"generator\" content=\"DoxyPress " << versionString << "\"/>" << endl;
+      t << "<link rel=\"stylesheet\" type=\"text/css\" href=\"search.css\"/>" << endl;
+      t << "<script type=\"text/javascript\" src=\"searchdata.js\"></script>" << endl;
+      t << "<script type=\"text/javascript\" src=\"search.js\"></script>" << endl;
+      t << "</head>" << endl;
+      t << "<body class=\"SRPage\">" << endl;
+      t << "<div id=\"SRIndex\">" << endl;
+      t << "<div class=\"SRStatus\" id=\"Loading\">" << theTranslator->trLoading() << "</div>" << endl;
+      t << "<div id=\"SRResults\"></div>" << endl;
+
+      t << "<div class=\"SRStatus\" id=\"Searching\">"
+        << theTranslator->trSearching() << "</div>" << endl;
+
+      t << "<div class=\"SRStatus\" id=\"NoMatches\">"
+        << theTranslator->trNoMatches() << "</div>" << endl;
+
+      t << "<script type=\"text/javascript\"><!--" << endl;
+      t << "document.getElementById(\"NoMatches\").style.display=\"none\";" << endl;
+      t << "var searchResults = new SearchResults(\"searchResults\");" << endl;
+      t << "loadSearchShards();" << endl;
+      t << "--></script>" << endl;
+      t << "</div>" << endl; // SRIndex
+      t << "</body>" << endl;
+      t << "</html>" << endl;
+
+   } else {
+      err("Unable to open file for writing %s, error: %d\n", csPrintable(f.fileName()), f.error());
+
+   }
+
+   msg("Search index: %d items in %d shards, %.1f KB\n", itemCount, shardKeys.count(), bytesWritten / 1024.0);
+}
+
 void writeJavascriptSearchIndex()
 {
    const bool generateHtml = Config::getBool("generate-html");
@@ -835,7 +1429,14 @@ void writeJavascriptSearchIndex()
    // write index files
    QString searchDirName = Config::getString("html-output") + "/search";
 
-   for (int i = 0; i < NUM_SEARCH_INDICES; i++) {
+   static const bool compactIndex = Config::getBool("search-compact-index");
+   QStringList shardKeys;
+
+   if (compactIndex) {
+      writeCompactSearchIndex(searchDirName, shardKeys);
+   }
+
+   for (int i = 0; i < NUM_SEARCH_INDICES && ! compactIndex; i++) {
       // for each index
       int p = 0;
 
@@ -913,197 +1514,48 @@ void writeJavascriptSearchIndex()
                }
                firstEntry = false;
 
-               QString dispName = d->localName();
-
-               if (d->definitionType() == Definition::TypeGroup) {
-                  dispName = d.dynamicCast<GroupDef>()->groupTitle();
-
-               } else if (d->definitionType() == Definition::TypePage) {
-                  dispName = d.dynamicCast<PageDef>()->title();
-
-               }
+               QString dispName = searchDisplayName(d);
 
                ti << "  ['" << searchId(dispName) << "',['"
                   << convertToXML(dispName) << "',[";
 
                if (dl->count() == 1) {
                   // item with a unique name
-                  QSharedPointer<MemberDef> md;
-
-                  bool isMemberDef = d->definitionType() == Definition::TypeMember;
-                  if (isMemberDef) {
-                     md = d.dynamicCast<MemberDef>();
-                  }
-
                   QString anchor = d->anchor();
 
-                  ti << "'" << externalRef("../", d->getReference(), true)
-                     << d->getOutputFileBase() << Doxy_Globals::htmlFileExtension;
-                  if (!anchor.isEmpty()) {
-                     ti << "#" << anchor;
-                  }
-                  ti << "',";
+                  ti << "'" << searchFileUrl(d);
 
-                  static bool extLinksInWindow = Config::getBool("external-links-in-window");
-                  if (!extLinksInWindow || d->getReference().isEmpty()) {
-                     ti << "1,";
-                  } else {
-                     ti << "0,";
+                  if (! anchor.isEmpty()) {
+                     ti << "#" << anchor;
                   }
 
-                  if (d->getOuterScope() != Doxy_Globals::globalScope) {
-                     ti << "'" << convertToXML(d->getOuterScope()->name()) << "'";
-
-                  } else if (md) {
-                     QSharedPointer<FileDef> fd = md->getBodyDef();
-
-                     if (fd == 0) {
-                        fd = md->getFileDef();
-                     }
-                     if (fd) {
-                        ti << "'" << convertToXML(fd->localName()) << "'";
-                     }
-
-                  } else {
-                     ti << "''";
-                  }
+                  ti << "'," << (searchTargetParent(d) ? "1," : "0,");
+                  ti << "'" << searchScope(d) << "'";
 
                   ti << "]]";
 
                } else {
                   // multiple items with the same name
-                  bool overloadedFunction = false;
+                  QStringList names = searchChildNames(dl);
                   int childCount = 0;
 
-                  QSharedPointer<Definition> next;
-                  QSharedPointer<Definition> prevScope;
-
-                  auto nextIter = dl->begin();
-
                   for (auto d : *dl)  {
-                     QSharedPointer<Definition> scope = d->getOuterScope();
-
-                     if (nextIter != dl->end()) {
-                        ++nextIter;
-                     }
-
-                     if (nextIter == dl->end()) {
-                        next = QSharedPointer<Definition>();
-
-                     } else {
-                        next = *nextIter;
-
-                     }
-
-                     QSharedPointer<Definition> nextScope;
-                     QSharedPointer<MemberDef>  md;
-
-                     bool isMemberDef = d->definitionType() == Definition::TypeMember;
-
-                     if (isMemberDef) {
-                        md = d.dynamicCast<MemberDef>();
-                     }
-
-                     if (next) {
-                        nextScope = next->getOuterScope();
-                     }
-
                      QString anchor = d->anchor();
 
                      if (childCount > 0) {
                         ti << "],[";
                      }
-                     ti << "'" << externalRef("../", d->getReference(), true)
-                        << d->getOutputFileBase() << Doxy_Globals::htmlFileExtension;
-
-                     if (!anchor.isEmpty()) {
-                        ti << "#" << anchor;
-                     }
-                     ti << "',";
-
-                     static bool extLinksInWindow = Config::getBool("external-links-in-window");
-                     if (! extLinksInWindow || d->getReference().isEmpty()) {
-                        ti << "1,";
-                     } else {
-                        ti << "0,";
-                     }
-
-                     bool found = false;
-                     overloadedFunction = ((prevScope != 0 && scope == prevScope) || (scope && scope == nextScope))
-                                             && md && (md->isFunction() || md->isSlot());
-
-                     QString prefix;
-
-                     if (md) {
-                        prefix = convertToXML(md->localName());
-                     }
-
-                     if (overloadedFunction) {
-                        // overloaded member function
-                        prefix += convertToXML(md->argsString());
-                        // show argument list to disambiguate overloaded functions
-
-                     } else if (md) {
-                        // unique member function
-                        prefix += "()"; // only to show it is a function
-                     }
-
-                     QString name;
-                     if (d->definitionType() == Definition::TypeClass) {
 
-                        name  = convertToXML(d.dynamicCast<ClassDef>()->displayName());
-                        found = true;
-
-                     } else if (d->definitionType() == Definition::TypeNamespace) {
-
-                        name  = convertToXML(d.dynamicCast<NamespaceDef>()->displayName());
-                        found = true;
-
-                     } else if (scope == 0 || scope == Doxy_Globals::globalScope) {
-                        // in global scope
-
-                        if (md) {
-                           QSharedPointer<FileDef> fd = md->getBodyDef();
-
-                           if (fd == 0) {
-                              fd = md->getFileDef();
-                           }
-
-                           if (fd) {
-                              if (! prefix.isEmpty()) {
-                                 prefix += ":&#160;";
-                              }
-                              name = prefix + convertToXML(fd->localName());
-                              found = true;
-                           }
-                        }
-
-                     } else if (md && (md->getClassDef() || md->getNamespaceDef())) {
-                        // member in class or namespace scope
-
-                        SrcLangExt lang = md->getLanguage();
-                        name = convertToXML(d->getOuterScope()->qualifiedName())
-                               + getLanguageSpecificSeparator(lang) + prefix;
-
-                        found = true;
-
-                     } else if (scope) {
-                        // some thing else? -> show scope
-
-                        name = prefix + convertToXML(scope->name());
-                        found = true;
-                     }
+                     ti << "'" << searchFileUrl(d);
 
-                     if (! found) {
-                        // fallback
-                        name = prefix + "(" + theTranslator->trGlobalNamespace() + ")";
+                     if (! anchor.isEmpty()) {
+                        ti << "#" << anchor;
                      }
 
-                     ti << "'" << name << "'";
+                     ti << "'," << (searchTargetParent(d) ? "1," : "0,");
+                     ti << "'" << names[childCount] << "'";
 
-                     prevScope = scope;
                      childCount++;
-
                   }
 
                   ti << "]]";
@@ -1217,6 +1669,50 @@ void writeJavascriptSearchIndex()
          }
 
          t << "};" << endl << endl;
+
+         if (compactIndex) {
+            // categories of each index, bit n + 1 is set for index n
+            t << "var indexSectionMasks =" << endl;
+            t << "{" << endl;
+
+            first = true;
+            j = 0;
+
+            for (int i = 0; i < NUM_SEARCH_INDICES; i++) {
+               if (g_searchIndexCount[i] > 0) {
+
+                  if (! first) {
+                     t << "," << endl;
+                  }
+
+                  t << "  " << j << ": " << (2 << i);
+                  first = false;
+                  j++;
+               }
+            }
+
+            if (! first) {
+               t << "\n";
+            }
+
+            t << "};" << endl << endl;
+
+            // first characters of the names in each shard
+            t << "var searchShards = [";
+
+            first = true;
+
+            for (const auto &key : shardKeys) {
+               if (! first) {
+                  t << ",";
+               }
+
+               t << searchJsString(key);
+               first = false;
+            }
+
+            t << "];" << endl << endl;
+         }
       }
 
       ResourceMgr::instance().copyResourceAs("html/search.js", searchDirName, "search.js");
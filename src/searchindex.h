@@ -19,10 +19,13 @@
 #ifndef SEARCHINDEX_H
 #define SEARCHINDEX_H
 
+#include <QByteArray>
+#include <QElapsedTimer>
 #include <QHash>
 #include <QList>
 #include <QVector>
 
+#include <searchmap.h>
 #include <stringmap.h>
 
 class Definition;
@@ -39,12 +42,6 @@ struct URL {
    QString url;
 };
 
-struct URLInfo {
-   URLInfo(int idx, int f) : urlIdx(idx), freq(f) {}
-   int urlIdx;
-   int freq;
-};
-
 class SearchDefinitionList : public QList<QSharedPointer<Definition>>
 {
    public:
@@ -59,25 +56,6 @@ class SearchDefinitionList : public QList<QSharedPointer<Definition>>
       QChar m_letter;
 };
 
-class IndexWord
-{
- public:
-   IndexWord(const QString &word);
-   void addUrlIndex(int, bool);
-
-   const QHash<long, QSharedPointer<URLInfo>> &urls() const {
-      return m_urls;
-   }
-
-   QString word() const {
-      return m_word;
-   }
-
- private:
-   QString m_word;
-   QHash<long, QSharedPointer<URLInfo>> m_urls;
-};
-
 class SearchIndex_Base
 {
  public:
@@ -110,9 +88,28 @@ class SearchIndex : public SearchIndex_Base
    void write(const QString &file) override;
 
  private:
-   void addWord(const QString &word, bool hiPrio, bool recurse);
+   struct IndexWord {
+      QByteArray word;
+      uint hash;
+
+      // documents are numbered in the order they are visited, postings are appended in order
+      QVector<SearchMap::Posting> postings;
+   };
 
-   QMap<QString, QSharedPointer<IndexWord>> m_words;
+   void addWordPart(const char *word, int length, bool hiPriority);
+
+   // open addressing table of indexes into m_words, -1 marks an empty slot
+   QVector<IndexWord> m_words;
+   QVector<int> m_wordTable;
+
+   // reused by addWord for the lower case word and the offsets of its parts
+   QByteArray m_wordBuffer;
+   QVector<int> m_wordParts;
+
+   qint64 m_wordsAdded;
+   qint64 m_wordsSampled;
+   qint64 m_addWordTime;
+   QElapsedTimer m_timer;
 
    QHash<QString,int> m_url2IdMap;
    QHash<long, QSharedPointer<URL>> m_urls;
@@ -138,4 +135,11 @@ class SearchIndex_External : public SearchIndex_Base
 
 void writeJavascriptSearchIndex();
 
+/** Writes the search.idx file used by search.php and the search.map file next to it, the words must be
+ *  sorted so words starting with the same two characters are adjacent. Returns the size of the buffer
+ *  used or -1 if the files could not be written
+ */
+qint64 writeSearchIndex(const QString &fileName, const QVector<SearchMap::Word> &words,
+                  const QVector<SearchMap::Document> &docs);
+
 #endif
@@ -0,0 +1,629 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#include <QSharedPointer>
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#include <searchmap.h>
+
+#include <message.h>
+
+// increase when the layout of the file changes
+static const quint32 searchMapVersion = 1;
+
+// number of words in each prefix compressed block
+static const int blockSize = 16;
+
+enum HeaderField {
+   Magic,
+   Version,
+   WordCount,
+   BlockCount,
+   UrlCount,
+   RestartsOffset,
+   WordsOffset,
+   PostingsOffset,
+   UrlIndexOffset,
+   UrlDataOffset,
+   FileSize,
+   Reserved,
+   HeaderFields
+};
+
+static const quint32 searchMapMagic = 'D' | ('X' << 8) | ('S' << 16) | ('M' << 24);
+static const int headerSize = HeaderFields * 4;
+
+static void setInt(QByteArray &buffer, int pos, quint32 value)
+{
+   buffer[pos]     = char(value & 0xff);
+   buffer[pos + 1] = char((value >> 8) & 0xff);
+   buffer[pos + 2] = char((value >> 16) & 0xff);
+   buffer[pos + 3] = char(value >> 24);
+}
+
+static void putVarint(QByteArray &buffer, quint32 value)
+{
+   while (value >= 0x80) {
+      buffer.append(char((value & 0x7f) | 0x80));
+      value >>= 7;
+   }
+
+   buffer.append(char(value));
+}
+
+static quint32 readInt(const uchar *data)
+{
+   return quint32(data[0]) | (quint32(data[1]) << 8) | (quint32(data[2]) << 16) | (quint32(data[3]) << 24);
+}
+
+static bool readVarint(const uchar *&pos, const uchar *end, quint32 &value)
+{
+   value = 0;
+
+   for (int shift = 0; shift < 35 && pos < end; shift += 7) {
+      uchar c = *pos++;
+      value |= quint32(c & 0x7f) << shift;
+
+      if (! (c & 0x80)) {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+// compares as unsigned bytes, which is the order of the code points in utf-8
+static int compareWords(const char *a, int aLen, const char *b, int bLen)
+{
+   int retval = memcmp(a, b, qMin(aLen, bLen));
+
+   if (retval == 0) {
+      retval = aLen - bLen;
+   }
+
+   return retval;
+}
+
+static bool startsWith(const QByteArray &word, const QByteArray &prefix)
+{
+   return word.size() >= prefix.size() && memcmp(word.constData(), prefix.constData(), prefix.size()) == 0;
+}
+
+// adds the occurrences of two postings for the same document
+static int mergeFreq(int freq1, int freq2)
+{
+   return (((freq1 >> 1) + (freq2 >> 1)) << 1) | ((freq1 | freq2) & 1);
+}
+
+/** Reads the words of a block and the words after it */
+struct WordCursor {
+   WordCursor(const uchar *start, const uchar *end)
+      : pos(start), end(end), postings(0)
+   { }
+
+   bool next() {
+      quint32 shared;
+      quint32 length;
+
+      if (! readVarint(pos, end, shared) || ! readVarint(pos, end, length)) {
+         return false;
+      }
+
+      if (shared > quint32(word.size()) || length > quint32(end - pos)) {
+         return false;
+      }
+
+      word.resize(shared);
+      word.append(reinterpret_cast<const char *>(pos), length);
+      pos += length;
+
+      return readVarint(pos, end, postings);
+   }
+
+   const uchar *pos;
+   const uchar *end;
+
+   QByteArray word;
+   quint32 postings;
+};
+
+bool SearchMap::write(const QString &fileName, QVector<Word> words, const QVector<Document> &docs)
+{
+   std::sort(words.begin(), words.end(), [] (const Word &a, const Word &b) {
+      return compareWords(a.word.constData(), a.word.size(), b.word.constData(), b.word.size()) < 0;
+   });
+
+   // the header, the block offsets and the words are built in place
+   const int blockCount = (words.count() + blockSize - 1) / blockSize;
+
+   QByteArray buffer(headerSize + (blockCount * 4), '\0');
+   QByteArray postings;
+
+   const int wordsOffset = buffer.size();
+
+   const QByteArray *previous = nullptr;
+
+   for (int i = 0; i < words.count(); ++i) {
+      Word &item = words[i];
+
+      std::sort(item.postings.begin(), item.postings.end(), [] (const Posting &a, const Posting &b) {
+         return a.urlIdx < b.urlIdx;
+      });
+
+      quint32 postingOffset = postings.size();
+      int lastIdx = 0;
+
+      putVarint(postings, item.postings.count());
+
+      for (const auto &posting : item.postings) {
+         putVarint(postings, posting.urlIdx - lastIdx);
+         putVarint(postings, posting.freq);
+
+         lastIdx = posting.urlIdx;
+      }
+
+      int shared = 0;
+
+      if (i % blockSize == 0) {
+         setInt(buffer, headerSize + (i / blockSize) * 4, buffer.size() - wordsOffset);
+
+      } else {
+         int maxShared = qMin(previous->size(), item.word.size());
+
+         while (shared < maxShared && previous->at(shared) == item.word.at(shared)) {
+            ++shared;
+         }
+      }
+
+      putVarint(buffer, shared);
+      putVarint(buffer, item.word.size() - shared);
+      buffer.append(item.word.constData() + shared, item.word.size() - shared);
+      putVarint(buffer, postingOffset);
+
+      previous = &item.word;
+   }
+
+   setInt(buffer, Magic * 4,          searchMapMagic);
+   setInt(buffer, Version * 4,        searchMapVersion);
+   setInt(buffer, WordCount * 4,      words.count());
+   setInt(buffer, BlockCount * 4,     blockCount);
+   setInt(buffer, UrlCount * 4,       docs.count());
+   setInt(buffer, RestartsOffset * 4, headerSize);
+   setInt(buffer, WordsOffset * 4,    wordsOffset);
+
+   setInt(buffer, PostingsOffset * 4, buffer.size());
+   buffer.append(postings);
+   postings = QByteArray();
+
+   // offset tables are aligned
+   while (buffer.size() % 4 != 0) {
+      buffer.append('\0');
+   }
+
+   // the url offsets are relative to the start of the url data which follows the table
+   const int urlIndexOffset = buffer.size();
+
+   setInt(buffer, UrlIndexOffset * 4, urlIndexOffset);
+   buffer.append(QByteArray((docs.count() + 1) * 4, '\0'));
+
+   const int urlDataOffset = buffer.size();
+   setInt(buffer, UrlDataOffset * 4,  urlDataOffset);
+
+   for (int i = 0; i < docs.count(); ++i) {
+      setInt(buffer, urlIndexOffset + (i * 4), buffer.size() - urlDataOffset);
+
+      buffer.append(docs[i].name.toUtf8());
+      buffer.append('\0');
+      buffer.append(docs[i].url.toUtf8());
+      buffer.append('\0');
+   }
+
+   setInt(buffer, urlIndexOffset + (docs.count() * 4), buffer.size() - urlDataOffset);
+   setInt(buffer, FileSize * 4,       buffer.size());
+
+   QFile f(fileName);
+
+   if (! f.open(QIODevice::WriteOnly)) {
+      err("Unable to open file for writing %s, error: %d\n", csPrintable(fileName), f.error());
+      return false;
+   }
+
+   if (f.write(buffer) != buffer.size()) {
+      err("Unable to write search index %s, error: %d\n", csPrintable(fileName), f.error());
+      return false;
+   }
+
+   return true;
+}
+
+SearchMap::SearchMap()
+   : m_data(nullptr), m_size(0)
+{
+}
+
+SearchMap::~SearchMap()
+{
+   close();
+}
+
+bool SearchMap::open(const QString &fileName)
+{
+   close();
+
+   m_file.setFileName(fileName);
+
+   if (! m_file.open(QIODevice::ReadOnly)) {
+      return false;
+   }
+
+   m_size = m_file.size();
+
+   if (m_size >= headerSize) {
+      m_data = m_file.map(0, m_size);
+   }
+
+   if (m_data == nullptr) {
+      close();
+      return false;
+   }
+
+   bool valid = header(Magic) == searchMapMagic && header(Version) == searchMapVersion && header(FileSize) == m_size;
+
+   // each section must follow the previous one
+   valid = valid && header(RestartsOffset) == quint32(headerSize)
+         && header(RestartsOffset) + 4 * quint64(header(BlockCount)) <= header(WordsOffset)
+         && header(WordsOffset) <= header(PostingsOffset) && header(PostingsOffset) <= header(UrlIndexOffset)
+         && header(UrlIndexOffset) + 4 * (quint64(header(UrlCount)) + 1) <= header(UrlDataOffset)
+         && header(UrlDataOffset) <= m_size;
+
+   valid = valid && header(BlockCount) == (header(WordCount) + blockSize - 1) / blockSize;
+
+   if (! valid) {
+      close();
+      return false;
+   }
+
+   return true;
+}
+
+void SearchMap::close()
+{
+   if (m_data != nullptr) {
+      m_file.unmap(const_cast<uchar *>(m_data));
+      m_data = nullptr;
+   }
+
+   m_file.close();
+   m_size = 0;
+}
+
+quint32 SearchMap::header(int index) const
+{
+   return readInt(m_data + 4 * index);
+}
+
+int SearchMap::wordCount() const
+{
+   return isOpen() ? header(WordCount) : 0;
+}
+
+int SearchMap::documentCount() const
+{
+   return isOpen() ? header(UrlCount) : 0;
+}
+
+SearchMap::Document SearchMap::document(int urlIdx) const
+{
+   Document retval;
+
+   if (urlIdx < 0 || urlIdx >= documentCount()) {
+      return retval;
+   }
+
+   const uchar *index = m_data + header(UrlIndexOffset) + 4 * urlIdx;
+
+   quint32 start = header(UrlDataOffset) + readInt(index);
+   quint32 end   = header(UrlDataOffset) + readInt(index + 4);
+
+   if (start > end || end > m_size) {
+      return retval;
+   }
+
+   const char *name = reinterpret_cast<const char *>(m_data + start);
+   const char *last = reinterpret_cast<const char *>(m_data + end);
+
+   const char *url = static_cast<const char *>(memchr(name, '\0', last - name));
+
+   if (url != nullptr) {
+      retval.name = QString::fromUtf8(name, url - name);
+
+      ++url;
+      const char *urlEnd = static_cast<const char *>(memchr(url, '\0', last - url));
+
+      retval.url = QString::fromUtf8(url, (urlEnd != nullptr ? urlEnd : last) - url);
+   }
+
+   return retval;
+}
+
+QByteArray SearchMap::blockWord(int block) const
+{
+   const uchar *start = m_data + header(WordsOffset) + readInt(m_data + header(RestartsOffset) + 4 * block);
+   const uchar *end   = m_data + header(PostingsOffset);
+
+   WordCursor cursor(start, end);
+
+   if (start >= end || ! cursor.next()) {
+      return QByteArray();
+   }
+
+   return cursor.word;
+}
+
+bool SearchMap::readPostings(quint32 offset, int urlBase, QVector<Posting> &postings) const
+{
+   const uchar *pos = m_data + header(PostingsOffset) + offset;
+   const uchar *end = m_data + header(UrlIndexOffset);
+
+   quint32 count;
+
+   if (pos >= end || ! readVarint(pos, end, count)) {
+      return false;
+   }
+
+   quint32 urlIdx = 0;
+
+   for (quint32 i = 0; i < count; ++i) {
+      quint32 delta;
+      quint32 freq;
+
+      if (! readVarint(pos, end, delta) || ! readVarint(pos, end, freq)) {
+         return false;
+      }
+
+      urlIdx += delta;
+      postings.append(Posting(urlBase + urlIdx, freq));
+   }
+
+   return true;
+}
+
+QVector<SearchMap::Posting> SearchMap::findPrefix(const QByteArray &prefix) const
+{
+   QVector<Posting> retval;
+
+   if (! isOpen() || header(BlockCount) == 0) {
+      return retval;
+   }
+
+   // last block whose first word is not larger than the prefix
+   int low  = 0;
+   int high = header(BlockCount) - 1;
+
+   while (low < high) {
+      int mid = (low + high + 1) / 2;
+      QByteArray word = blockWord(mid);
+
+      if (compareWords(word.constData(), word.size(), prefix.constData(), prefix.size()) <= 0) {
+         low = mid;
+      } else {
+         high = mid - 1;
+      }
+   }
+
+   WordCursor cursor(m_data + header(WordsOffset) + readInt(m_data + header(RestartsOffset) + 4 * low),
+         m_data + header(PostingsOffset));
+
+   while (cursor.pos < cursor.end && cursor.next()) {
+
+      if (! startsWith(cursor.word, prefix)) {
+         if (compareWords(cursor.word.constData(), cursor.word.size(), prefix.constData(), prefix.size()) > 0) {
+            // sorted, no more words with this prefix
+            break;
+         }
+
+         continue;
+      }
+
+      if (! readPostings(cursor.postings, 0, retval)) {
+         break;
+      }
+   }
+
+   // several words can occur in the same document
+   std::sort(retval.begin(), retval.end(), [] (const Posting &a, const Posting &b) {
+      return a.urlIdx < b.urlIdx;
+   });
+
+   int count = 0;
+
+   for (int i = 0; i < retval.count(); ++i) {
+      if (count > 0 && retval[count - 1].urlIdx == retval[i].urlIdx) {
+         retval[count - 1].freq = mergeFreq(retval[count - 1].freq, retval[i].freq);
+      } else {
+         retval[count++] = retval[i];
+      }
+   }
+
+   retval.resize(count);
+
+   return retval;
+}
+
+QVector<SearchMap::Match> SearchMap::query(const QString &text) const
+{
+   QVector<Match> retval;
+   QVector<Posting> result;
+
+   bool first = true;
+   QString word;
+
+   for (int i = 0; i <= text.length(); ++i) {
+
+      if (i < text.length() && ! text[i].isSpace()) {
+         word += text[i];
+         continue;
+      }
+
+      if (word.isEmpty()) {
+         continue;
+      }
+
+      QVector<Posting> postings = findPrefix(word.toLower().toUtf8());
+      word = QString();
+
+      if (first) {
+         result = postings;
+         first  = false;
+
+      } else {
+         // documents which contain all words
+         QVector<Posting> both;
+
+         auto iter1 = result.begin();
+         auto iter2 = postings.begin();
+
+         while (iter1 != result.end() && iter2 != postings.end()) {
+
+            if (iter1->urlIdx < iter2->urlIdx) {
+               ++iter1;
+
+            } else if (iter2->urlIdx < iter1->urlIdx) {
+               ++iter2;
+
+            } else {
+               both.append(Posting(iter1->urlIdx, mergeFreq(iter1->freq, iter2->freq)));
+               ++iter1;
+               ++iter2;
+            }
+         }
+
+         result = both;
+      }
+
+      if (result.isEmpty()) {
+         break;
+      }
+   }
+
+   for (const auto &item : result) {
+      Match match;
+
+      match.urlIdx     = item.urlIdx;
+      match.freq       = item.freq >> 1;
+      match.hiPriority = item.freq & 1;
+
+      retval.append(match);
+   }
+
+   std::sort(retval.begin(), retval.end(), [] (const Match &a, const Match &b) {
+      if (a.hiPriority != b.hiPriority) {
+         return a.hiPriority;
+      }
+
+      if (a.freq != b.freq) {
+         return a.freq > b.freq;
+      }
+
+      return a.urlIdx < b.urlIdx;
+   });
+
+   return retval;
+}
+
+bool SearchMap::merge(const QStringList &fileNames, const QStringList &urlPrefixes, QVector<Word> &words,
+                  QVector<Document> &docs)
+{
+   int count = fileNames.count();
+
+   QVector<QSharedPointer<SearchMap>> indexes;
+   std::vector<WordCursor> cursors;
+   QVector<int> urlBase;
+
+   for (int i = 0; i < count; ++i) {
+      QSharedPointer<SearchMap> index = QMakeShared<SearchMap>();
+
+      if (! index->open(fileNames[i])) {
+         err("Unable to open search index %s\n", csPrintable(fileNames[i]));
+         return false;
+      }
+
+      urlBase.append(docs.count());
+
+      for (int j = 0; j < index->documentCount(); ++j) {
+         Document doc = index->document(j);
+         doc.url.prepend(urlPrefixes.value(i));
+
+         docs.append(doc);
+      }
+
+      cursors.push_back(WordCursor(index->m_data + index->header(WordsOffset), index->m_data + index->header(PostingsOffset)));
+      indexes.append(index);
+   }
+
+   // indexes of the cursors which have a current word, smallest word and then the first index on top
+   auto greater = [&cursors] (int a, int b) {
+      const QByteArray &wordA = cursors[a].word;
+      const QByteArray &wordB = cursors[b].word;
+
+      int cmp = compareWords(wordA.constData(), wordA.size(), wordB.constData(), wordB.size());
+
+      return cmp > 0 || (cmp == 0 && a > b);
+   };
+
+   std::vector<int> heap;
+
+   for (int i = 0; i < count; ++i) {
+      if (cursors[i].pos < cursors[i].end && cursors[i].next()) {
+         heap.push_back(i);
+      }
+   }
+
+   std::make_heap(heap.begin(), heap.end(), greater);
+
+   while (! heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end(), greater);
+      int i = heap.back();
+      heap.pop_back();
+
+      // the documents of each index are numbered after the documents of the previous indexes,
+      // so the postings of an equal word remain sorted when appended in the order of the indexes
+      if (words.isEmpty() || words.last().word != cursors[i].word) {
+         Word word;
+         word.word = cursors[i].word;
+
+         words.append(word);
+      }
+
+      if (! indexes[i]->readPostings(cursors[i].postings, urlBase[i], words.last().postings)) {
+         err("Search index %s is damaged\n", csPrintable(fileNames[i]));
+         return false;
+      }
+
+      if (cursors[i].pos < cursors[i].end && cursors[i].next()) {
+         heap.push_back(i);
+         std::push_heap(heap.begin(), heap.end(), greater);
+      }
+   }
+
+   return true;
+}
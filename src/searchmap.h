@@ -0,0 +1,104 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#ifndef SEARCHMAP_H
+#define SEARCHMAP_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/** Server side search index which is read directly from a memory mapped file.
+ *
+ *  The words are sorted and stored in blocks of 16, each block starts with a complete
+ *  word and the other words only store the part which differs from the previous word.
+ *  A table with the offset of each block allows a binary search on the first words.
+ *  The documents of a word are stored as varints, sorted by document and delta encoded.
+ *  All integers in the header and in the offset tables are 32 bit little endian.
+ */
+class SearchMap
+{
+ public:
+   struct Posting {
+      Posting() : urlIdx(0), freq(0) {}
+      Posting(int idx, int f) : urlIdx(idx), freq(f) {}
+
+      int urlIdx;
+      int freq;         // number of occurrences times two, bit 0 is set for a high priority match
+   };
+
+   struct Word {
+      QByteArray word;  // lower case, utf-8
+      QVector<Posting> postings;
+   };
+
+   struct Document {
+      QString name;
+      QString url;
+   };
+
+   struct Match {
+      int urlIdx;
+      int freq;
+      bool hiPriority;
+   };
+
+   SearchMap();
+   ~SearchMap();
+
+   /** Writes the index, the words do not need to be sorted, urlIdx refers to \a docs */
+   static bool write(const QString &fileName, QVector<Word> words, const QVector<Document> &docs);
+
+   bool open(const QString &fileName);
+   void close();
+
+   bool isOpen() const {
+      return m_data != nullptr;
+   }
+
+   int wordCount() const;
+   int documentCount() const;
+
+   Document document(int urlIdx) const;
+
+   /** Returns the documents containing a word starting with \a prefix, sorted by document */
+   QVector<Posting> findPrefix(const QByteArray &prefix) const;
+
+   /** Returns the documents containing every word of \a text as a prefix, best matches first */
+   QVector<Match> query(const QString &text) const;
+
+   /** Combines the words and documents of several indexes, the documents of index n are numbered after
+    *  the documents of the previous indexes and \a urlPrefixes[n] is prepended to their urls
+    */
+   static bool merge(const QStringList &fileNames, const QStringList &urlPrefixes, QVector<Word> &words,
+         QVector<Document> &docs);
+
+ private:
+   quint32 header(int index) const;
+   QByteArray blockWord(int block) const;
+   bool readPostings(quint32 offset, int urlBase, QVector<Posting> &postings) const;
+
+   QFile  m_file;
+   const uchar *m_data;
+   qint64 m_size;
+};
+
+#endif
@@ -0,0 +1,84 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#include <symboltable.h>
+
+int SymbolTable::intern(const QString &name)
+{
+   auto iter = m_ids.constFind(name);
+
+   if (iter != m_ids.constEnd()) {
+      return iter.value();
+   }
+
+   int id = m_names.count();
+
+   m_ids.insert(name, id);
+   m_names.append(name);
+
+   return id;
+}
+
+int SymbolTable::find(const QString &name) const
+{
+   return m_ids.value(name, -1);
+}
+
+const QVector<Definition *> &SymbolTable::definitions(int id) const
+{
+   if (id < 0 || id >= m_definitions.count()) {
+      return m_empty;
+   }
+
+   return m_definitions[id];
+}
+
+const QVector<Definition *> &SymbolTable::definitions(const QString &name) const
+{
+   return definitions(find(name));
+}
+
+void SymbolTable::insert(const QString &name, Definition *def)
+{
+   int id = intern(name);
+
+   if (id >= m_definitions.count()) {
+      m_definitions.resize(id + 1);
+   }
+
+   // the most recent definition is listed first, which is the order the lookups depend on
+   m_definitions[id].prepend(def);
+}
+
+void SymbolTable::remove(const QString &name, Definition *def)
+{
+   int id = find(name);
+
+   if (id < 0 || id >= m_definitions.count()) {
+      return;
+   }
+
+   QVector<Definition *> &list = m_definitions[id];
+
+   for (int i = list.size() - 1; i >= 0; --i) {
+      if (list[i] == def) {
+         list.remove(i);
+      }
+   }
+}
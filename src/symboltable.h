@@ -0,0 +1,82 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2019 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class Definition;
+
+/** Table of interned names, each name is given an integer id which does not change while DoxyPress runs.
+ *
+ *  The table also holds the glossary, for each local name the list of definitions with this
+ *  name. Scope names are interned as well so lookups can be keyed on ids instead of on
+ *  concatenated strings. Definitions are listed most recent first.
+ *
+ *  A list returned by definitions() stays valid while names are interned, adding or removing
+ *  a definition invalidates it.
+ */
+class SymbolTable
+{
+ public:
+   /** Returns the id of \a name, the name is added when it is not in the table */
+   int intern(const QString &name);
+
+   /** Returns the id of \a name or -1 if the name is not in the table */
+   int find(const QString &name) const;
+
+   /** Returns the name for \a id */
+   const QString &name(int id) const {
+      return m_names[id];
+   }
+
+   /** Returns the number of names in the table */
+   int count() const {
+      return m_names.count();
+   }
+
+   /** Returns the definitions for \a id, the list is empty if there are none */
+   const QVector<Definition *> &definitions(int id) const;
+
+   /** Returns the definitions named \a name, the list is empty if there are none */
+   const QVector<Definition *> &definitions(const QString &name) const;
+
+   /** Returns true if there is at least one definition named \a name */
+   bool contains(const QString &name) const {
+      return ! definitions(name).isEmpty();
+   }
+
+   void insert(const QString &name, Definition *def);
+   void remove(const QString &name, Definition *def);
+
+ private:
+   QHash<QString, int> m_ids;
+
+   QVector<QString> m_names;
+
+   // only grows when a definition is added, interning a name does not move the lists
+   QVector<QVector<Definition *>> m_definitions;
+
+   QVector<Definition *> m_empty;
+};
+
+#endif
@@ -37,6 +37,7 @@
 #include <doxy_build_info.h>
 #include <entry.h>
 #include <example.h>
+#include <filecache.h>
 #include <htmlentity.h>
 #include <image.h>
 #include <language.h>
@@ -72,6 +73,17 @@ static QSet<QString> s_aliasesProcessed;
 
 static QCache<QPair<const FileNameDict *, QString>, FindFileCacheElem> s_findFileDefCache;
 
+// canonical types and results of matchArguments2(), cleared whenever the lookup cache is cleared
+// and limited to the size of the lookup cache, a match result is the index of the first argument
+// which does not match or -1
+static QCache<QString, QString> s_canonicalTypeCache;
+static QCache<QString, int>     s_argumentMatchCache;
+
+static int s_canonicalTypeHits   = 0;
+static int s_canonicalTypeMisses = 0;
+static int s_argumentMatchHits   = 0;
+static int s_argumentMatchMisses = 0;
+
 // forward declaration
 static QSharedPointer<ClassDef> getResolvedClassRec(QSharedPointer<const Definition> scope, QSharedPointer<const FileDef> fileScope,
                   const QString &n, QSharedPointer<MemberDef> *pTypeDef, QString *pTemplSpec, QString *pResolvedType);
@@ -698,9 +710,9 @@ static QString substTypedef(QSharedPointer<const Definition> scopeDef, QSharedPo
       return result;
    }
 
-   auto iter = Doxy_Globals::glossary().find(phraseName);
+   const QVector<Definition *> &defList = Doxy_Globals::glossary().definitions(phraseName);
 
-   if (iter == Doxy_Globals::glossary().end()) {
+   if (defList.isEmpty()) {
       // could not find a matching def
       return QString("");
    }
@@ -709,12 +721,12 @@ static QString substTypedef(QSharedPointer<const Definition> scopeDef, QSharedPo
 
    QSharedPointer<MemberDef> bestMatch;
 
-   while (iter != Doxy_Globals::glossary().end() && iter.key() == phraseName)  {
+   for (auto item : defList) {
       // search for the best match, only look at members
 
-      if (iter.value()->definitionType() == Definition::TypeMember) {
+      if (item->definitionType() == Definition::TypeMember) {
          // which are also typedefs
-         QSharedPointer<Definition> sharedPtr = sharedFrom(iter.value());
+         QSharedPointer<Definition> sharedPtr = sharedFrom(item);
          QSharedPointer<MemberDef> md = sharedPtr.dynamicCast<MemberDef>();
 
          if (md->isTypedef()) {
@@ -729,8 +741,6 @@ static QString substTypedef(QSharedPointer<const Definition> scopeDef, QSharedPo
             }
          }
       }
-
-      ++iter;
    }
 
    if (bestMatch) {
@@ -1391,14 +1401,17 @@ static QSharedPointer<ClassDef> getResolvedClassRec(QSharedPointer<const Definit
       return QSharedPointer<ClassDef>();
    }
 
-   auto iter = Doxy_Globals::glossary().find(name);
+   SymbolTable &glossary = Doxy_Globals::glossary();
+   int nameId = glossary.find(name);
 
-   if (iter == Doxy_Globals::glossary().end() ) {
+   if (glossary.definitions(nameId).isEmpty()) {
       // -p (for ObjC protocols)
 
-      if (! Doxy_Globals::glossary().contains(name + "-p")) {
+      if (! glossary.contains(name + "-p")) {
          return QSharedPointer<ClassDef>();
       }
+
+      nameId = glossary.intern(name);
    }
 
    bool hasUsingStatements = (fileScope && ((fileScope->getUsedNamespaces() &&
@@ -1407,35 +1420,30 @@ static QSharedPointer<ClassDef> getResolvedClassRec(QSharedPointer<const Definit
 
    // it is often the case that the same name is searched in the same scope
    // use a cache to collect previous results
-   // the key is the concatenated scope, the name to search for and the explicit scope prefix
+   // the key is made of the symbol ids of the scope, the name to search for and the explicit scope prefix
 
-   int scopeNameLen    = scope->name().length() + 1;
-   int nameLen         = name.length() + 1;
-   int explicitPartLen = explicitScopePart.length();
-
-   int fileScopeLen;
-
-   if (hasUsingStatements) {
-       fileScopeLen = 1 + fileScope->getFilePath().length();
-
-   } else {
-      fileScopeLen = 0;
+   int explicitScopeId = -1;
 
+   if (! explicitScopePart.isEmpty()) {
+      explicitScopeId = glossary.intern(explicitScopePart);
    }
 
-   QString key = scope->name( ) + "+" + name + "+" + explicitScopePart;
-
    // if a file scope is given and contains using statements we should also use the file part
    // in the key (as a class name can be in two different namespaces and a using statement in
    // a file can select one of them)
 
+   int fileScopeId = -1;
+
    if (hasUsingStatements) {
-      key += "+" + fileScope->name();
+      fileScopeId = glossary.intern(fileScope->name());
    }
 
+   LookupKey key(qMakePair(glossary.intern(scope->name()), nameId), qMakePair(explicitScopeId, fileScopeId));
+
    LookupInfo *pval = Doxy_Globals::lookupCache.object(key);
 
    if (pval) {
+      ++Doxy_Globals::lookupCacheHits;
 
       if (pTemplSpec) {
          *pTemplSpec = pval->templSpec;
@@ -1453,6 +1461,7 @@ static QSharedPointer<ClassDef> getResolvedClassRec(QSharedPointer<const Definit
 
    } else {
       // not found, add a null object to avoid endless recursion
+      ++Doxy_Globals::lookupCacheMisses;
       Doxy_Globals::lookupCache.insert(key, new LookupInfo);
 
    }
@@ -1466,12 +1475,14 @@ static QSharedPointer<ClassDef> getResolvedClassRec(QSharedPointer<const Definit
    // init at "infinite"
    int minDistance = 10000;
 
-   while (iter != Doxy_Globals::glossary().end() && iter.key() == name)  {
-      QSharedPointer<Definition> def = sharedFrom(iter.value());
+   // copy of the list, resolving a symbol can recurse into this method and add definitions
+   const QVector<Definition *> defList = glossary.definitions(nameId);
+
+   for (auto item : defList) {
+      QSharedPointer<Definition> def = sharedFrom(item);
 
       getResolvedSymbol(scope, fileScope, def, explicitScopePart, &actTemplParams,
                         minDistance, bestMatch, bestTypedef, bestTemplSpec, bestResolvedType);
-      ++iter;
    }
 
    if (pTypeDef) {
@@ -2320,6 +2331,11 @@ void setAnchors(QSharedPointer<MemberList> ml)
  */
 QString filterCRLF(const QString &buffer)
 {
+   if (! buffer.contains('\r') && ! buffer.contains(QChar(0))) {
+      // nothing to translate, return the shared buffer instead of a copy
+      return buffer;
+   }
+
    QString retval = buffer;
 
    retval.replace("\r\n",   "\n");
@@ -2412,6 +2428,11 @@ QString getFileFilter(const QString &name, bool isSourceCode)
 }
 
 QString transcodeToQString(const QByteArray &input)
+{
+   return transcodeToQString(input.constData(), input.size());
+}
+
+QString transcodeToQString(const char *input, int size)
 {
    static const QString inputEncoding = Config::getString("input-encoding");
 
@@ -2419,10 +2440,10 @@ QString transcodeToQString(const QByteArray &input)
 
    if (! tmp) {
       err("Unsupported character encoding: '%s'\n", csPrintable(inputEncoding));
-      return input;
+      return QString::fromUtf8(input, size);
    }
 
-   return tmp->toUnicode(input);
+   return tmp->toUnicode(input, size);
 }
 
 /*  reads a file with name and returns it as a string. If filter
@@ -3247,7 +3268,27 @@ static QString getCanonicalTypeForIdentifier(QSharedPointer<Definition> d, QShar
    return result;
 }
 
-static QString extractCanonicalType(QSharedPointer<Definition> def, QSharedPointer<FileDef> fs, QString type)
+// key part for the scope and file scope used to resolve a type, names are used like in the lookup cache
+static QString canonicalScopeKey(QSharedPointer<const Definition> def, QSharedPointer<const FileDef> fs)
+{
+   QString retval;
+
+   if (def) {
+      retval = QString::number(def->definitionType()) + def->qualifiedName();
+   }
+
+   retval += '\t';
+
+   if (fs) {
+      retval += fs->getFilePath();
+   }
+
+   retval += '\t';
+
+   return retval;
+}
+
+static QString computeCanonicalType(QSharedPointer<Definition> def, QSharedPointer<FileDef> fs, QString type)
 {
    type = type.trimmed();
 
@@ -3321,7 +3362,32 @@ static QString extractCanonicalType(QSharedPointer<Definition> def, QSharedPoint
    return removeRedundantWhiteSpace(canType);
 }
 
-static QString extractCanonicalArgType(QSharedPointer<Definition> d, QSharedPointer<FileDef> fs, const Argument &arg)
+static QString extractCanonicalType(QSharedPointer<Definition> def, QSharedPointer<FileDef> fs, QString type)
+{
+   QString key = canonicalScopeKey(def, fs) + type;
+
+   QString *pval = s_canonicalTypeCache.object(key);
+
+   if (pval) {
+      ++s_canonicalTypeHits;
+      return *pval;
+   }
+
+   ++s_canonicalTypeMisses;
+
+   QString retval = computeCanonicalType(def, fs, std::move(type));
+
+   if (s_canonicalTypeCache.maxCost() != Doxy_Globals::lookupCache.maxCost()) {
+      s_canonicalTypeCache.setMaxCost(Doxy_Globals::lookupCache.maxCost());
+   }
+
+   s_canonicalTypeCache.insert(key, new QString(retval));
+
+   return retval;
+}
+
+// type of an argument including the parts the parser may have put in the name or the array
+static QString argumentTypeString(const Argument &arg)
 {
    QString type = arg.type.trimmed();
    QString name = arg.name;
@@ -3345,7 +3411,12 @@ static QString extractCanonicalArgType(QSharedPointer<Definition> d, QSharedPoin
       type += arg.array;
    }
 
-   return extractCanonicalType(d, fs, type);
+   return type;
+}
+
+static QString extractCanonicalArgType(QSharedPointer<Definition> d, QSharedPointer<FileDef> fs, const Argument &arg)
+{
+   return extractCanonicalType(d, fs, argumentTypeString(arg));
 }
 
 // called from matchArguments2
@@ -3354,14 +3425,6 @@ static bool matchArgument_Internal(QSharedPointer<Definition> srcScope, QSharedP
             QSharedPointer<Definition> dstScope, QSharedPointer<FileDef> dstFileScope,
             const Argument &dstArg)
 {
-   QString srcName = " " + srcArg.name;
-   QString dstName = " " + dstArg.name;
-   QString srcType = srcArg.type;
-   QString dstType = dstArg.type;
-
-   stripIrrelevantConstVolatile(srcType);
-   stripIrrelevantConstVolatile(dstType);
-
    if (srcArg.canType.isEmpty()) {
       srcArg.canType = extractCanonicalArgType(srcScope, srcFileScope, srcArg);
    }
@@ -3436,25 +3499,91 @@ bool matchArguments2(QSharedPointer<Definition> srcScope, QSharedPointer<FileDef
    }
 
    // so far the argument lists could match, need to compare the types of all arguments
-   auto dst_iter = dstArgList.begin();
+   // an argument whose canonical type is already known is part of the key with this type
+   QString key = canonicalScopeKey(srcScope, srcFileScope) + canonicalScopeKey(dstScope, dstFileScope);
 
-   for (auto &srcArg : srcArgList) {
+   for (const auto *argList : { &srcArgList, &dstArgList }) {
+      for (const auto &arg : *argList) {
 
-      if (dst_iter == dstArgList.end()) {
-         return false;
+         if (arg.canType.isEmpty()) {
+            key += argumentTypeString(arg);
+            key += '\n';
+
+         } else {
+            key += '=';
+            key += arg.canType;
+            key += '\n';
+         }
       }
 
-      // matchArgument_Internal may change the data in the local copies
-      bool retval = matchArgument_Internal(srcScope, srcFileScope, srcArg, dstScope, dstFileScope, *dst_iter);
+      key += '\t';
+   }
 
-      if (! retval) {
-         return false;
+   int *pval = s_argumentMatchCache.object(key);
+
+   if (pval) {
+      ++s_argumentMatchHits;
+
+      // copy, resolving a type below can add entries to the cache
+      int mismatch = *pval;
+
+      // set the canonical types of the compared arguments, matchArgument_Internal() would have done so
+      int last = (mismatch == -1) ? srcArgList.count() - 1 : mismatch;
+      auto dst_iter = dstArgList.begin();
+
+      for (auto src_iter = srcArgList.begin(); src_iter != srcArgList.end() && last >= 0; ++src_iter, ++dst_iter, --last) {
+
+         if (src_iter->canType.isEmpty()) {
+            src_iter->canType = extractCanonicalArgType(srcScope, srcFileScope, *src_iter);
+         }
+
+         if (dst_iter->canType.isEmpty()) {
+            dst_iter->canType = extractCanonicalArgType(dstScope, dstFileScope, *dst_iter);
+         }
+      }
+
+      return mismatch == -1;
+   }
+
+   ++s_argumentMatchMisses;
+
+   int mismatch  = -1;
+   int index     = 0;
+   auto dst_iter = dstArgList.begin();
+
+   for (auto &srcArg : srcArgList) {
+
+      // matchArgument_Internal may change the data in the local copies
+      if (! matchArgument_Internal(srcScope, srcFileScope, srcArg, dstScope, dstFileScope, *dst_iter)) {
+         mismatch = index;
+         break;
       }
 
       ++dst_iter;
+      ++index;
+   }
+
+   if (s_argumentMatchCache.maxCost() != Doxy_Globals::lookupCache.maxCost()) {
+      s_argumentMatchCache.setMaxCost(Doxy_Globals::lookupCache.maxCost());
    }
 
-   return true;       // all arguments match
+   s_argumentMatchCache.insert(key, new int(mismatch));
+
+   return mismatch == -1;
+}
+
+void clearArgumentMatchCache()
+{
+   s_canonicalTypeCache.clear();
+   s_argumentMatchCache.clear();
+}
+
+void printArgumentMatchStatistics()
+{
+   if (s_argumentMatchHits + s_argumentMatchMisses > 0) {
+      msg("Argument match cache: %d hits, %d misses, canonical type cache: %d hits, %d misses\n",
+                  s_argumentMatchHits, s_argumentMatchMisses, s_canonicalTypeHits, s_canonicalTypeMisses);
+   }
 }
 
 // merges the initializer of two argument lists
@@ -6878,9 +7007,9 @@ QSharedPointer<MemberDef> getMemberFromSymbol(QSharedPointer<Definition> scope,
       return bestMatch;
    }
 
-   auto iter = Doxy_Globals::glossary().find(name);
+   const QVector<Definition *> &defList = Doxy_Globals::glossary().definitions(name);
 
-   if (iter == Doxy_Globals::glossary().end()) {
+   if (defList.isEmpty()) {
       return bestMatch;
    }
 
@@ -6902,25 +7031,22 @@ QSharedPointer<MemberDef> getMemberFromSymbol(QSharedPointer<Definition> scope,
    int minDistance = 10000;
 
    // find the closest matching definition
-   while (iter != Doxy_Globals::glossary().end() && iter.key() == name)  {
+   for (auto item : defList) {
       // search for the best match, only look at members
 
-      if (iter.value()->definitionType() == Definition::TypeMember) {
+      if (item->definitionType() == Definition::TypeMember) {
          s_visitedNamespaces.clear();
 
-         QSharedPointer<Definition> def = sharedFrom(iter.value());
+         QSharedPointer<Definition> def = sharedFrom(item);
          int distance = isAccessibleFromWithExpScope(scope, fileScope, def, explicitScopePart);
 
          if (distance != -1 && distance < minDistance) {
             minDistance = distance;
 
-            QSharedPointer<Definition> def = sharedFrom(iter.value());
-            QSharedPointer<MemberDef> md   = def.dynamicCast<MemberDef>();
+            QSharedPointer<MemberDef> md = def.dynamicCast<MemberDef>();
             bestMatch = md;
          }
       }
-
-      ++iter;
    }
 
    return bestMatch;
@@ -6955,13 +7081,12 @@ QString parseCommentAsText(QSharedPointer<const Definition> scope, QSharedPointe
       QSharedPointer<MemberDef> md_unconst = md.constCast<MemberDef>();
 
       QTextStream t_stream(&s);
-      DocNode *root = validatingParseDoc(fileName, lineNr, scope_unconst, md_unconst, doc, false, false);
+      QSharedPointer<DocRoot> root = cachedParseDoc(fileName, lineNr, scope_unconst, md_unconst, doc, false, false);
 
       TextDocVisitor *visitor = new TextDocVisitor(t_stream);
       root->accept(visitor);
 
       delete visitor;
-      delete root;
    }
 
    QString result = convertCharEntities(s);
@@ -7374,6 +7499,43 @@ QString readInputFile(const QString &fileName)
    return retval;
 }
 
+// decode the contents of a file
+static void decodeInputFile(const char *data, int size, QString &fileContents)
+{
+   const uchar *bytes = reinterpret_cast<const uchar *>(data);
+
+   uchar tmp0 = 0;
+   uchar tmp1 = 0;
+   uchar tmp2 = 0;
+
+   if (size >= 2) {
+      tmp0 = bytes[0];
+      tmp1 = bytes[1];
+   }
+
+   if (size >= 3) {
+      tmp2 = bytes[2];
+   }
+
+   if ((tmp0 == 0xFF && tmp1 == 0xFE) || (tmp0 == 0xFE && tmp1 == 0xFF)) {
+      // UCS-2 encoded file
+      fileContents = QTextCodec::codecForMib(1015)->toUnicode(data, size);
+
+   } else if (tmp0 == 0xEF && tmp1 == 0xBB && tmp2 == 0xBF) {
+      // UTF-8 encoded file, skip the UTF-8 BOM, no translation needed
+      fileContents = QString::fromUtf8(data + 3, size - 3);
+
+   } else {
+      // transcode according to the INPUT_ENCODING setting
+      // do character transcoding if needed
+
+      fileContents = transcodeToQString(data, size);
+   }
+
+   // translate CR's
+   fileContents = filterCRLF(fileContents);
+}
+
 // read a file name
 bool readInputFile(const QString &fileName, QString &fileContents, bool filter, bool isSourceCode)
 {
@@ -7382,11 +7544,17 @@ bool readInputFile(const QString &fileName, QString &fileContents, bool filter,
       return false;
    }
 
-   // holds the data for fileContents
-   QByteArray buffer;
-
    QString filterName = getFileFilter(fileName, isSourceCode);
-   int size = 0;
+
+   // a file is read by several passes, the filter only runs when the file is not cached
+   bool useFilter = ! filterName.isEmpty() && filter;
+
+   FileContentCache *fileCache = FileContentCache::instance();
+   QString cacheKey = fileCache->key(fi, useFilter ? filterName : QString());
+
+   if (fileCache->find(cacheKey, fileContents)) {
+      return true;
+   }
 
    if (filterName.isEmpty() || ! filter) {
       // do not filter
@@ -7398,12 +7566,25 @@ bool readInputFile(const QString &fileName, QString &fileContents, bool filter,
          return false;
       }
 
-      size = fi.size();
-      buffer.resize(size);
+      qint64 size = fi.size();
 
-      if (f.read(buffer.data(), size) != size) {
-         err("Unable to read file %s, error: %d\n", csPrintable(fileName), f.error());
-         return false;
+      // decode directly from the mapped file, the contents are not copied to an intermediate buffer
+      uchar *data = size > 0 ? f.map(0, size) : nullptr;
+
+      if (data != nullptr) {
+         decodeInputFile(reinterpret_cast<const char *>(data), size, fileContents);
+         f.unmap(data);
+
+      } else {
+         QByteArray buffer;
+         buffer.resize(size);
+
+         if (f.read(buffer.data(), size) != size) {
+            err("Unable to read file %s, error: %d\n", csPrintable(fileName), f.error());
+            return false;
+         }
+
+         decodeInputFile(buffer.constData(), buffer.size(), fileContents);
       }
 
    } else {
@@ -7419,46 +7600,17 @@ bool readInputFile(const QString &fileName, QString &fileContents, bool filter,
          return false;
       }
 
-      buffer = filterProcess.readAllStandardOutput();
+      QByteArray buffer = filterProcess.readAllStandardOutput();
 
       QByteArray errorMsg = filterProcess.readAllStandardError();
        if (! errorMsg.isEmpty()) {
          err("Possible filter problem: %s\n", errorMsg.constData());
       }
-   }
-
-   uchar tmp0 = 0;
-   uchar tmp1 = 0;
-   uchar tmp2 = 0;
-
-   if (size >= 2) {
-      tmp0 = buffer.at(0);
-      tmp1 = buffer.at(1);
-   }
-
-   if (size >= 3) {
-      tmp2 = buffer.at(2);
-   }
-
-   if ((tmp0 == 0xFF && tmp1 == 0xFE) || (tmp0 == 0xFE && tmp1 == 0xFF)) {
-      // UCS-2 encoded file
-      fileContents = QTextCodec::codecForMib(1015)->toUnicode(buffer);
-
-   } else if (tmp0 == 0xEF && tmp1 == 0xBB && tmp2 == 0xBF) {
-      // UTF-8 encoded file, remove UTF-8 BOM, no translation needed
-
-      buffer = buffer.mid(3);
-      fileContents  = QString::fromUtf8(buffer);
-
-   } else {
-      // transcode according to the INPUT_ENCODING setting
-      // do character transcoding if needed
 
-      fileContents = transcodeToQString(buffer);
+      decodeInputFile(buffer.constData(), buffer.size(), fileContents);
    }
 
-   // translate CR's
-   fileContents = filterCRLF(fileContents);
+   fileCache->insert(cacheKey, fileContents, useFilter);
 
    return true;
 }
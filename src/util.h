@@ -142,6 +142,7 @@ QChar   charToUpper(const QString &s, int index);
 bool    classVisibleInIndex(QSharedPointer<ClassDef> cd);
 bool    classHasVisibleChildren(QSharedPointer<ClassDef> cd);
 bool    copyFile(const QString &src, const QString &dest);
+void    clearArgumentMatchCache();
 bool    checkIfTypedef(QSharedPointer<Definition> scope, QSharedPointer<FileDef> fileScope,const QString &name);
 int     computeQualifiedIndex(const QString &name);
 int     countAliasArguments(const QString &argList);
@@ -226,6 +227,7 @@ QString normalizeNonTemplateArgumentsInString(const QString &name, QSharedPointe
 
 bool    namespaceHasVisibleChild(QSharedPointer<NamespaceDef> nd, bool includeClasses);
 
+void    printArgumentMatchStatistics();
 QString parseCommentAsText(QSharedPointer<const Definition> scope, QSharedPointer<const MemberDef> member,
                   const QString &doc, const QString &fileName, int lineNr);
 
@@ -275,6 +277,7 @@ void    stackTrace();
 void    setAnchors(QSharedPointer<MemberList> ml);
 
 QString transcodeToQString(const QByteArray &input);
+QString transcodeToQString(const char *input, int size);
 QString tempArgListToString(const ArgumentList &al, SrcLangExt lang);
 
 QString upperCaseFirstLetter(QString &&text);
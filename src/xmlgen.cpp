@@ -503,7 +503,7 @@ static void writeXMLDocBlock(QTextStream &t, const QString &fileName, int lineNr
    }
 
    // convert the documentation string into an abstract syntax tree
-   DocNode *root = validatingParseDoc(fileName, lineNr, scope, md, text, false, false);
+   QSharedPointer<DocRoot> root = cachedParseDoc(fileName, lineNr, scope, md, text, false, false);
 
    // create a code generator
    XMLCodeGenerator *xmlCodeGen = new XMLCodeGenerator(t);
@@ -517,7 +517,6 @@ static void writeXMLDocBlock(QTextStream &t, const QString &fileName, int lineNr
    // clean up
    delete visitor;
    delete xmlCodeGen;
-   delete root;
 }
 
 void writeXMLCodeBlock(QTextStream &t, QSharedPointer<FileDef> fd)